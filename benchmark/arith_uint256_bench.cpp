@@ -0,0 +1,48 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <benchmark/benchmark.h>
+
+#include <veriblock/arith_uint256.hpp>
+#include <veriblock/blockchain/btc_blockchain_util.hpp>
+
+using namespace altintegration;
+
+static const ArithUint256 kNum = ArithUint256::fromHex(
+    "7D1DE5EAF9B156D53208F033B5AA8122D2d2355d5e12292b121156cfdb4a529c");
+static const ArithUint256 kDiv = ArithUint256::fromHex(
+    "00000000000000000000000000000000000000000000000ad7133ac1977fa2b7");
+
+static void BM_Add(benchmark::State& state) {
+  ArithUint256 a = kNum;
+  for (auto _ : state) {
+    a += kDiv;
+    benchmark::DoNotOptimize(a);
+  }
+}
+BENCHMARK(BM_Add);
+
+static void BM_Multiply(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kNum * kDiv);
+  }
+}
+BENCHMARK(BM_Multiply);
+
+static void BM_Divide(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kNum / kDiv);
+  }
+}
+BENCHMARK(BM_Divide);
+
+static void BM_BlockProof(benchmark::State& state) {
+  BtcBlock block;
+  block.bits = 0x1d00ffff;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(getBlockProof(block));
+  }
+}
+BENCHMARK(BM_BlockProof);
@@ -0,0 +1,53 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <veriblock/uint.hpp>
+
+using namespace altintegration;
+
+// hasher which was used for Blob before - copies bytes into std::string
+struct StringBlobHasher {
+  size_t operator()(const uint256& x) const {
+    return std::hash<std::string>{}(std::string{x.begin(), x.end()});
+  }
+};
+
+static std::vector<uint256> makeKeys(size_t size) {
+  std::mt19937_64 rng(0);
+  std::vector<uint256> keys(size);
+  for (auto& key : keys) {
+    for (auto& b : key) {
+      b = static_cast<uint8_t>(rng());
+    }
+  }
+  return keys;
+}
+
+// lookups in 1M-entry map of the same shape as BlockTree::valid_blocks
+template <typename Hasher>
+static void BM_ValidBlocksLookup(benchmark::State& state) {
+  const size_t size = 1000000;
+  auto keys = makeKeys(size);
+  std::unordered_map<uint256, std::shared_ptr<int>, Hasher> map;
+  map.reserve(size);
+  for (const auto& key : keys) {
+    map[key] = std::make_shared<int>(0);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(keys[i]));
+    i = (i + 7919) % size;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ValidBlocksLookup, StringBlobHasher);
+BENCHMARK_TEMPLATE(BM_ValidBlocksLookup, std::hash<uint256>);
@@ -0,0 +1,41 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <veriblock/blockchain/block_index.hpp>
+
+using namespace altintegration;
+
+using index_t = BlockIndex<BtcBlock>;
+
+static std::vector<index_t> makeChain(int size, bool withSkip) {
+  std::vector<index_t> chain(size);
+  for (int i = 0; i < size; i++) {
+    chain[i].height = i;
+    chain[i].pprev = i == 0 ? nullptr : &chain[i - 1];
+    if (withSkip) {
+      chain[i].buildSkip();
+    }
+  }
+  return chain;
+}
+
+// args: chain depth, whether skip-list pointers are built
+static void BM_GetAncestor(benchmark::State& state) {
+  const auto size = static_cast<int>(state.range(0));
+  const auto chain = makeChain(size, state.range(1) != 0);
+  const auto& tip = chain.back();
+
+  int height = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tip.getAncestor(height));
+    height = (height + 7919) % size;
+  }
+}
+BENCHMARK(BM_GetAncestor)
+    ->ArgsProduct({{10000, 1000000}, {0, 1}})
+    ->ArgNames({"depth", "skip"});
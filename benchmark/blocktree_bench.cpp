@@ -0,0 +1,73 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <vector>
+#include <veriblock/blockchain/pop/vbk_block_tree.hpp>
+
+using namespace altintegration;
+
+namespace generated {
+extern const char vbk_blockheaders_mainnet_200001_230000[];
+}
+
+static std::vector<VbkBlock> readMainnetHeaders() {
+  std::vector<VbkBlock> ret;
+  std::istringstream file(generated::vbk_blockheaders_mainnet_200001_230000);
+  std::string data;
+  while (file >> data) {
+    auto v = ParseHex(data);
+    if (!v.empty()) {
+      ret.push_back(VbkBlock::fromRaw(v));
+    }
+  }
+  return ret;
+}
+
+// accepts VBK mainnet headers 200001..230000 on top of a bootstrapped tree
+// args: whether headers are accepted in a single batch
+static void BM_AcceptVbkHeaders(benchmark::State& state) {
+  static const auto blocks = readMainnetHeaders();
+  VbkChainParamsMain vbkparam;
+  BtcChainParamsMain btcparam;
+  const auto bootstrapSize = vbkparam.numBlocksForBootstrap() * 2;
+  const std::vector<VbkBlock> bootstrap{blocks.begin(),
+                                        blocks.begin() + bootstrapSize};
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    VbkBlockTree tree(vbkparam, btcparam);
+    ValidationState valState;
+    if (!tree.bootstrapWithChain(bootstrap[0].height, bootstrap, valState)) {
+      state.SkipWithError("bootstrap failed");
+      break;
+    }
+    state.ResumeTiming();
+
+    if (state.range(0) != 0) {
+      Slice<const VbkBlock> batch(blocks.data() + bootstrapSize,
+                                  blocks.size() - bootstrapSize);
+      if (!tree.acceptBlocks(batch, valState)) {
+        state.SkipWithError("batch is not accepted");
+      }
+      continue;
+    }
+
+    for (size_t i = bootstrapSize; i < blocks.size(); i++) {
+      if (!tree.acceptBlock(blocks[i], valState)) {
+        state.SkipWithError("block is not accepted");
+        break;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (blocks.size() - bootstrapSize));
+}
+BENCHMARK(BM_AcceptVbkHeaders)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgName("batch")
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,101 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <benchmark/benchmark.h>
+
+#include <thread>
+#include <veriblock/blockchain/alt_chain_params.hpp>
+#include <veriblock/mock_miner.hpp>
+#include <veriblock/stateless_validation.hpp>
+
+using namespace altintegration;
+
+struct AltChainParamsBench : public AltChainParams {
+  AltBlock getBootstrapBlock() const noexcept override {
+    AltBlock b;
+    b.hash = {1, 2, 3};
+    return b;
+  }
+
+  uint32_t getIdentifier() const noexcept override { return 0; }
+};
+
+// payloads are mined once and shared by all benchmark threads
+struct Payloads {
+  AltChainParamsBench altparam;
+  MockMiner popminer;
+  ATV atv;
+  VTB vtb;
+
+  Payloads() {
+    ValidationState state;
+    auto* vbkTip = popminer.mineVbkBlocks(10);
+
+    // VTB endorsing VBK tip
+    auto btctx = popminer.createBtcTxEndorsingVbkBlock(*vbkTip->header);
+    auto* btcTip = popminer.mineBtcBlocks(1);
+    auto poptx = popminer.createVbkPopTxEndorsingVbkBlock(
+        *btcTip->header,
+        btctx,
+        *vbkTip->header,
+        popminer.getBtcParams().getGenesisBlock().getHash());
+    popminer.vbkmempool.push_back(poptx);
+    vbkTip = popminer.mineVbkBlocks(1);
+    vtb = popminer.vbkPayloads.at(vbkTip->getHash()).at(0);
+
+    // ATV endorsing ALT bootstrap block
+    PublicationData pub;
+    pub.identifier = altparam.getIdentifier();
+    pub.header = altparam.getBootstrapBlock().toVbkEncoding();
+    auto vbktx = popminer.endorseAltBlock(pub);
+    atv = popminer.generateATV(vbktx, vbkTip->getHash(), state);
+  }
+};
+
+static const Payloads& getPayloads() {
+  static const Payloads payloads;
+  return payloads;
+}
+
+static void BM_CheckATV(benchmark::State& state) {
+  const auto& p = getPayloads();
+  ValidationState valState;
+  // each thread validates its own copy
+  ATV atv = p.atv;
+  for (auto _ : state) {
+    // do not let ATV skip validation as already checked
+    atv.checked = false;
+    if (!checkATV(atv, valState, p.altparam, p.popminer.getVbkParams())) {
+      state.SkipWithError("invalid ATV");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckATV)
+    ->ThreadRange(1, (int)std::thread::hardware_concurrency())
+    ->UseRealTime();
+
+static void BM_CheckVTB(benchmark::State& state) {
+  const auto& p = getPayloads();
+  ValidationState valState;
+  // each thread validates its own copy
+  VTB vtb = p.vtb;
+  for (auto _ : state) {
+    // do not let VTB skip validation as already checked
+    vtb.checked = false;
+    if (!checkVTB(vtb,
+                  valState,
+                  p.popminer.getVbkParams(),
+                  p.popminer.getBtcParams())) {
+      state.SkipWithError("invalid VTB");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckVTB)
+    ->ThreadRange(1, (int)std::thread::hardware_concurrency())
+    ->UseRealTime();
@@ -28,6 +28,26 @@ function(addtest test_name)
     disable_clang_tidy(${test_name})
 endfunction()
 
+# adds benchmark executable, which uses google benchmark. Not registered in ctest.
+function(addbench bench_name)
+    set(THREADS_PREFER_PTHREAD_FLAG TRUE)
+    find_package(Threads REQUIRED)
+    find_package(benchmark REQUIRED)
+
+    add_executable(${bench_name} ${ARGN})
+    target_link_libraries(${bench_name}
+            ${LIB_NAME}
+            benchmark::benchmark_main
+            benchmark::benchmark
+            Threads::Threads
+            )
+    set_target_properties(${bench_name} PROPERTIES
+            CXX_STANDARD 17
+            CXX_STANDARD_REQUIRED TRUE
+            )
+    disable_clang_tidy(${bench_name})
+endfunction()
+
 function(addtest_part test_name)
     if (POLICY CMP0076)
         cmake_policy(SET CMP0076 NEW)
@@ -35,14 +35,13 @@ template <typename Block, typename ChainParams>
 bool addBlocks(BlockTree<Block, ChainParams>& tree,
                const std::vector<std::vector<uint8_t>>& blocks,
                ValidationState& state) {
+  std::vector<Block> parsed;
+  parsed.reserve(blocks.size());
   for (const auto& b : blocks) {
-    Block block = Block::fromRaw(b);
-    if (!tree.acceptBlock(block, state)) {
-      return false;
-    }
+    parsed.push_back(Block::fromRaw(b));
   }
 
-  return true;
+  return tree.acceptBlocks(parsed, state);
 }
 
 }  // namespace altintegration
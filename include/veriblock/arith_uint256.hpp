@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <cstring>
 #include <limits>
 #include <stdexcept>
@@ -39,94 +40,70 @@ class ArithUint256 : public Blob<SHA256_HASH_SIZE> {
     assign(b);
   }
 
-  ArithUint256(uint64_t b) {
-    data_[0] = (uint8_t)b;
-    data_[1] = (uint8_t)(b >> 8);
-    data_[2] = (uint8_t)(b >> 16);
-    data_[3] = (uint8_t)(b >> 24);
-    data_[4] = (uint8_t)(b >> 32);
-    data_[5] = (uint8_t)(b >> 40);
-    data_[6] = (uint8_t)(b >> 48);
-    data_[7] = (uint8_t)(b >> 56);
-    for (int i = 8; i < SHA256_HASH_SIZE; i++) {
-      data_[i] = 0;
-    }
-  }
+  ArithUint256(uint64_t b) { setLimbs({{b, 0, 0, 0}}); }
 
   const ArithUint256 operator~() const {
     ArithUint256 ret;
-    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-      ret.data_[i] = ~data_[i];
+    auto a = limbs();
+    for (auto& limb : a) {
+      limb = ~limb;
     }
+    ret.setLimbs(a);
     return ret;
   }
 
   const ArithUint256 operator-() const {
-    ArithUint256 ret;
-    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-      ret.data_[i] = ~data_[i];
-    }
+    ArithUint256 ret = ~(*this);
     ++ret;
     return ret;
   }
 
   ArithUint256& operator=(uint64_t b) {
-    data_[0] = (uint8_t)b;
-    data_[1] = (uint8_t)(b >> 8);
-    data_[2] = (uint8_t)(b >> 16);
-    data_[3] = (uint8_t)(b >> 24);
-    data_[4] = (uint8_t)(b >> 32);
-    data_[5] = (uint8_t)(b >> 40);
-    data_[6] = (uint8_t)(b >> 48);
-    data_[7] = (uint8_t)(b >> 56);
-    for (int i = 8; i < SHA256_HASH_SIZE; i++) {
-      data_[i] = 0;
-    }
+    setLimbs({{b, 0, 0, 0}});
     return *this;
   }
 
   ArithUint256& operator^=(const ArithUint256& b) {
-    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-      data_[i] ^= b.data_[i];
+    auto a = limbs();
+    const auto c = b.limbs();
+    for (int i = 0; i < WIDTH; i++) {
+      a[i] ^= c[i];
     }
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator&=(const ArithUint256& b) {
-    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-      data_[i] &= b.data_[i];
+    auto a = limbs();
+    const auto c = b.limbs();
+    for (int i = 0; i < WIDTH; i++) {
+      a[i] &= c[i];
     }
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator|=(const ArithUint256& b) {
-    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-      data_[i] |= b.data_[i];
+    auto a = limbs();
+    const auto c = b.limbs();
+    for (int i = 0; i < WIDTH; i++) {
+      a[i] |= c[i];
     }
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator^=(uint64_t b) {
-    data_[0] ^= (uint8_t)b;
-    data_[1] ^= (uint8_t)(b >> 8);
-    data_[2] ^= (uint8_t)(b >> 16);
-    data_[3] ^= (uint8_t)(b >> 24);
-    data_[4] ^= (uint8_t)(b >> 32);
-    data_[5] ^= (uint8_t)(b >> 40);
-    data_[6] ^= (uint8_t)(b >> 48);
-    data_[7] ^= (uint8_t)(b >> 56);
+    auto a = limbs();
+    a[0] ^= b;
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator|=(uint64_t b) {
-    data_[0] |= (uint8_t)b;
-    data_[1] |= (uint8_t)(b >> 8);
-    data_[2] |= (uint8_t)(b >> 16);
-    data_[3] |= (uint8_t)(b >> 24);
-    data_[4] |= (uint8_t)(b >> 32);
-    data_[5] |= (uint8_t)(b >> 40);
-    data_[6] |= (uint8_t)(b >> 48);
-    data_[7] |= (uint8_t)(b >> 56);
+    auto a = limbs();
+    a[0] |= b;
+    setLimbs(a);
     return *this;
   }
 
@@ -134,31 +111,53 @@ class ArithUint256 : public Blob<SHA256_HASH_SIZE> {
   ArithUint256& operator>>=(unsigned int shift);
 
   ArithUint256& operator+=(const ArithUint256& b) {
+    auto a = limbs();
+    const auto c = b.limbs();
     uint64_t carry = 0;
-    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-      uint64_t n = carry + data_[i] + b.data_[i];
-      data_[i] = n & 0xff;
-      carry = n >> 8;
+    for (int i = 0; i < WIDTH; i++) {
+      uint64_t n = a[i] + carry;
+      carry = n < carry;
+      a[i] = n + c[i];
+      carry += a[i] < n;
     }
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator-=(const ArithUint256& b) {
-    *this += -b;
+    auto a = limbs();
+    const auto c = b.limbs();
+    uint64_t borrow = 0;
+    for (int i = 0; i < WIDTH; i++) {
+      uint64_t n = a[i] - borrow;
+      borrow = a[i] < borrow;
+      borrow += n < c[i];
+      a[i] = n - c[i];
+    }
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator+=(uint64_t b64) {
-    ArithUint256 b;
-    b = b64;
-    *this += b;
+    auto a = limbs();
+    a[0] += b64;
+    bool carry = a[0] < b64;
+    for (int i = 1; i < WIDTH && carry; i++) {
+      carry = ++a[i] == 0;
+    }
+    setLimbs(a);
     return *this;
   }
 
   ArithUint256& operator-=(uint64_t b64) {
-    ArithUint256 b;
-    b = b64;
-    *this += -b;
+    auto a = limbs();
+    uint64_t borrow = a[0] < b64;
+    a[0] -= b64;
+    for (int i = 1; i < WIDTH && borrow != 0; i++) {
+      borrow = a[i] == 0;
+      --a[i];
+    }
+    setLimbs(a);
     return *this;
   }
 
@@ -168,8 +167,10 @@ class ArithUint256 : public Blob<SHA256_HASH_SIZE> {
 
   ArithUint256& operator++() {
     // prefix operator
-    for (int i = 0; i < SHA256_HASH_SIZE && ++data_[i] == 0; ++i) {
+    auto a = limbs();
+    for (int i = 0; i < WIDTH && ++a[i] == 0; ++i) {
     }
+    setLimbs(a);
     return *this;
   }
 
@@ -182,10 +183,12 @@ class ArithUint256 : public Blob<SHA256_HASH_SIZE> {
 
   ArithUint256& operator--() {
     // prefix operator
-    for (int i = 0; i < SHA256_HASH_SIZE &&
-                    --data_[i] == std::numeric_limits<uint8_t>::max();
+    auto a = limbs();
+    for (int i = 0;
+         i < WIDTH && --a[i] == std::numeric_limits<uint64_t>::max();
          ++i) {
     }
+    setLimbs(a);
     return *this;
   }
 
@@ -283,6 +286,34 @@ class ArithUint256 : public Blob<SHA256_HASH_SIZE> {
   uint32_t toBits(bool negative = false) const;
 
   void setHex(const std::string& value);
+
+ private:
+  //! number of 64-bit limbs
+  static constexpr int WIDTH = SHA256_HASH_SIZE / 8;
+  //! little-endian limbs, limb 0 is the least significant one
+  using limbs_t = std::array<uint64_t, WIDTH>;
+
+  // Bytes in data_ are little-endian, so on little-endian hosts limbs are
+  // loaded and stored with plain moves.
+  limbs_t limbs() const {
+    limbs_t ret;
+    std::memcpy(ret.data(), data_.data(), SHA256_HASH_SIZE);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (auto& limb : ret) {
+      limb = __builtin_bswap64(limb);
+    }
+#endif
+    return ret;
+  }
+
+  void setLimbs(limbs_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (auto& limb : value) {
+      limb = __builtin_bswap64(limb);
+    }
+#endif
+    std::memcpy(data_.data(), value.data(), SHA256_HASH_SIZE);
+  }
 };
 
 /// custom gtest printer, which prints Blob of any size as hexstring
@@ -8,7 +8,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstring>
+#include <random>
 #include <string>
 
 #include "veriblock/slice.hpp"
@@ -189,6 +191,50 @@ void PrintTo(const Blob<size>& blob, ::std::ostream* os) {
   *os << blob.toHex();
 }
 
+namespace internal {
+
+//! random per-process salt for hash tables. Peers can not predict bucket
+//! collisions for keys they send us.
+inline uint64_t getHashSalt() {
+  static const uint64_t salt = []() {
+    std::random_device rd;
+    return (uint64_t(rd()) << 32) ^ uint64_t(rd());
+  }();
+  return salt;
+}
+
+//! splitmix64 finalizer
+inline uint64_t mixHash(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+//! salted hash of a byte array, which does not allocate. Bytes are read as
+//! machine words.
+inline size_t saltedHash(const uint8_t* data, size_t size) {
+  uint64_t h = getHashSalt() ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h = mixHash(h ^ word);
+  }
+
+  if (i < size) {
+    uint64_t word = 0;
+    memcpy(&word, data + i, size - i);
+    h = mixHash(h ^ word);
+  }
+
+  return static_cast<size_t>(h);
+}
+
+}  // namespace internal
+
 }  // namespace altintegration
 
 namespace std {
@@ -196,7 +242,7 @@ namespace std {
 template <size_t N>
 struct hash<altintegration::Blob<N>> {
   size_t operator()(const altintegration::Blob<N>& x) const {
-    return std::hash<std::string>{}(std::string{x.begin(), x.end()});
+    return altintegration::internal::saltedHash(x.data(), x.size());
   }
 };
 }  // namespace std
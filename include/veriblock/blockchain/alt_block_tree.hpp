@@ -9,9 +9,11 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "veriblock/blockchain/alt_chain_params.hpp"
+#include "veriblock/blockchain/arena.hpp"
 #include "veriblock/blockchain/block_index.hpp"
 #include "veriblock/blockchain/chain.hpp"
 #include "veriblock/blockchain/pop/fork_resolution.hpp"
@@ -36,11 +38,12 @@ struct AltTree {
   using alt_config_t = AltChainParams;
   using vbk_config_t = VbkChainParams;
   using btc_config_t = BtcChainParams;
+  using block_t = AltBlock;
   using index_t = BlockIndex<AltBlock>;
   using hash_t = typename AltBlock::hash_t;
   using context_t = typename index_t::block_t::context_t;
   using payloads_t = AltPayloads;
-  using block_index_t = std::unordered_map<hash_t, std::shared_ptr<index_t>>;
+  using block_index_t = std::unordered_map<hash_t, index_t*>;
   using PopForkComparator =
       PopAwareForkResolutionComparator<AltBlock, AltChainParams, VbkBlockTree>;
 
@@ -62,6 +65,22 @@ struct AltTree {
   //! may return false, if bootstrap block is invalid
   bool bootstrap(ValidationState& state);
 
+  /**
+   * Restore tree from blocks, which were previously stored from another tree.
+   * VBK tree must be loaded first, see VbkBlockTree::loadBlocks.
+   *
+   * Blocks must be sorted by height, the first one is used as a bootstrap
+   * block. Height, status and POP data are taken from storage.
+   *
+   * @param tip hash of the block, which POP state of the stored tree was set
+   * to, see getState. VBK tree has to correspond to it.
+   * @return true if tree is restored, false if some block does not connect
+   * to the previous ones, or tip is not a valid block.
+   */
+  bool loadBlocks(const std::vector<index_t>& blocks,
+                  const hash_t* tip,
+                  ValidationState& state);
+
   //! add new block to current block tree.
   //! may return false, if block has no connection to blockchain
   bool acceptBlock(const AltBlock& block, ValidationState& state);
@@ -90,6 +109,9 @@ struct AltTree {
   //! set POP state to some known block, for example, when we remove a block or
   bool setState(const AltBlock::hash_t& to, ValidationState& state);
 
+  //! @return block, which POP state is set to
+  const index_t* getState() const { return cmp_.getIndex(); }
+
   /**
    * Calculate payouts for the altchain tip
    * @return map with reward recipient as a key and reward amount as a value
@@ -123,6 +145,14 @@ struct AltTree {
   const block_index_t& getValidBlocks() const { return valid_blocks; }
   const block_index_t& getFailedBlocks() const { return failed_blocks; }
 
+  //! blocks, which were added or changed since the tree was loaded or since
+  //! the last call of clearChangedBlocks. See saveBlockTreeChanges.
+  const std::unordered_set<index_t*>& getChangedBlocks() const {
+    return changed_;
+  }
+
+  void clearChangedBlocks() { changed_.clear(); }
+
   bool operator==(const AltTree& o) const {
     return chainTips_ == o.chainTips_ && valid_blocks == o.valid_blocks &&
            failed_blocks == o.failed_blocks && cmp_ == o.cmp_;
@@ -156,6 +186,9 @@ struct AltTree {
 
  protected:
   std::unordered_set<index_t*> chainTips_{};
+  //! owns all block indices of the tree. Shared with copies of this tree,
+  //! because they refer to same block indices
+  std::shared_ptr<Arena<index_t>> arena_ = std::make_shared<Arena<index_t>>();
   block_index_t valid_blocks{};
   block_index_t failed_blocks{};
   const alt_config_t* alt_config_;
@@ -164,6 +197,9 @@ struct AltTree {
   PopForkComparator cmp_;
   PopRewards rewards_;
 
+  //! see getChangedBlocks
+  std::unordered_set<index_t*> changed_;
+
   index_t* insertBlockHeader(const AltBlock& block);
 
   //! same as unix `touch`: create-and-get if not exists, get otherwise
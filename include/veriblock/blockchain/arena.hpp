@@ -0,0 +1,115 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_ARENA_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_ARENA_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace altintegration {
+
+/**
+ * Slab allocator for objects of a single type.
+ *
+ * Objects are constructed in fixed-size slabs, so their addresses never
+ * change, and all of them are destroyed at once together with the arena.
+ * Released objects are reset to default state and reused by next `create`.
+ *
+ * @tparam T default-constructible and copy-assignable type
+ * @tparam SlabSize number of objects in a single slab
+ */
+template <typename T, size_t SlabSize = 1024>
+struct Arena {
+  static_assert(SlabSize > 0, "slab can not be empty");
+
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() {
+    for (size_t i = 0, size = slabs_.size(); i < size; i++) {
+      size_t used = (i + 1 == size) ? used_ : SlabSize;
+      auto* objects = reinterpret_cast<T*>(slabs_[i].get());
+      for (size_t j = 0; j < used; j++) {
+        objects[j].~T();
+      }
+    }
+  }
+
+  //! get default-constructed object, owned by the arena
+  T* create() {
+    if (!free_.empty()) {
+      T* object = free_.back();
+      free_.pop_back();
+      return object;
+    }
+
+    if (slabs_.empty() || used_ == SlabSize) {
+      slabs_.emplace_back(new storage_t[SlabSize]);
+      used_ = 0;
+    }
+
+    T* object = new (&slabs_.back()[used_]) T();
+    ++used_;
+    return object;
+  }
+
+  //! return object, created by this arena, for reuse
+  void release(T* object) {
+    *object = T();
+    free_.push_back(object);
+  }
+
+  //! remember object, which is not used by one of owners of the arena, but
+  //! may still be used by others. See releaseDeferred.
+  void defer(T* object) { deferred_.push_back(object); }
+
+  bool hasDeferred() const { return !deferred_.empty(); }
+
+  //! release deferred objects, for which `isUsed` returns false. Objects, for
+  //! which it returns true, are no longer deferred. Must be called by the
+  //! only remaining owner of the arena.
+  template <typename IsUsed>
+  void releaseDeferred(const IsUsed& isUsed) {
+    std::vector<T*> deferred;
+    deferred.swap(deferred_);
+    // object may be deferred by multiple owners
+    std::sort(deferred.begin(), deferred.end());
+    deferred.erase(std::unique(deferred.begin(), deferred.end()),
+                   deferred.end());
+    for (T* object : deferred) {
+      if (!isUsed(*object)) {
+        release(object);
+      }
+    }
+  }
+
+  //! number of objects, which are created and not released
+  size_t size() const {
+    if (slabs_.empty()) {
+      return 0;
+    }
+
+    return (slabs_.size() - 1) * SlabSize + used_ - free_.size();
+  }
+
+ private:
+  using storage_t =
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  std::vector<std::unique_ptr<storage_t[]>> slabs_;
+  //! number of constructed objects in the last slab
+  size_t used_ = 0;
+  std::vector<T*> free_;
+  std::vector<T*> deferred_;
+};
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_ARENA_HPP_
@@ -7,11 +7,13 @@
 #define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_BLOCK_INDEX_HPP_
 
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 #include <veriblock/validation_state.hpp>
 
 #include "veriblock/arith_uint256.hpp"
+#include "veriblock/consts.hpp"
 #include "veriblock/entities/btcblock.hpp"
 #include "veriblock/entities/endorsements.hpp"
 #include "veriblock/entities/payloads.hpp"
@@ -38,6 +40,38 @@ enum BlockStatus : uint8_t {
   BLOCK_FAILED_MASK = BLOCK_FAILED_CHILD | BLOCK_FAILED_POP | BLOCK_FAILED_BLOCK
 };
 
+//! turn the lowest '1' bit in the binary representation of a number into a '0'
+inline int32_t invertLowestOne(int32_t n) { return n & (n - 1); }
+
+//! compute what height to jump back to with the BlockIndex::pskip pointer
+inline int32_t getSkipHeight(int32_t height) {
+  if (height < 2) {
+    return 0;
+  }
+
+  // Determine which height to jump back to. Any number strictly lower than
+  // height is acceptable, but the following expression seems to perform well
+  // in simulations (max 110 steps to go back up to 2**18 blocks).
+  return (height & 1) ? invertLowestOne(invertLowestOne(height - 1)) + 1
+                      : invertLowestOne(height);
+}
+
+//! true if blocks of given type are protected by POP. Index of such block
+//! stores endorsements and context, which it contains, see BlockIndex::toRaw.
+template <typename Block>
+struct IsPopProtected : std::false_type {};
+
+template <>
+struct IsPopProtected<VbkBlock> : std::true_type {};
+
+template <>
+struct IsPopProtected<AltBlock> : std::true_type {};
+
+//! first byte of a BlockIndex record, see BlockIndex::toRaw. Records written
+//! before it was introduced start with the height, which is never negative,
+//! so their first byte does not have the highest bit set.
+constexpr const uint8_t BLOCK_INDEX_RAW_VERSION = 0x81;
+
 //! Store block
 template <typename Block>
 struct BlockIndex {
@@ -50,31 +84,108 @@ struct BlockIndex {
   using payloads_t = typename Block::payloads_t;
   using protecting_block_t = typename Block::protecting_block_t;
 
+  //! POP data of the block. Most blocks do not contain payloads and are not
+  //! endorsed, so it is stored separately from the index and allocated only
+  //! for blocks which have it.
+  struct PopData {
+    //! list of containing endorsements in this block
+    std::unordered_map<eid_t, std::shared_ptr<endorsement_t>>
+        containingEndorsements{};
+
+    //! list of endorsements pointing to this block
+    std::vector<endorsement_t*> endorsedBy;
+
+    //! digest of ids of `endorsedBy`, which does not depend on their order.
+    //! Same set of endorsements always has the same digest, so it is used to
+    //! validate caches, which are computed from `endorsedBy`.
+    uint64_t endorsedByDigest = 0;
+
+    //! list of containing context blocks that **change** current state
+    context_t containingContext{};
+
+    //! must be called after `e` is added to or removed from `endorsedBy`
+    void toggleEndorsedBy(const endorsement_t& e) {
+      endorsedByDigest ^= std::hash<eid_t>()(e.id);
+    }
+  };
+
+  // fields used by chain walks go first, to share a cache line
+
   //! pointer to a previous block
   BlockIndex* pprev{};
 
+  //! pointer to the index of some further predecessor of this block, used by
+  //! getAncestor for O(log n) lookups. May be nullptr.
+  BlockIndex* pskip{};
+
+  //! height of the entry in the chain
+  height_t height = 0;
+
+  //! contains status flags
+  uint8_t status = 0;  // unknown validity
+
   //! total amount of work in the chain up to and including this
   //! block
   ArithUint256 chainWork = 0;
 
-  //! list of containing endorsements in this block
-  std::unordered_map<eid_t, std::shared_ptr<endorsement_t>>
-      containingEndorsements{};
+  //! block header
+  std::shared_ptr<Block> header{};
 
-  //! list of endorsements pointing to this block
-  std::vector<endorsement_t*> endorsedBy;
+  //! most recently added child of this block. Other children are linked
+  //! through their 'pnextSibling'.
+  BlockIndex* pfirstChild{};
+
+  //! next child of 'pprev'
+  BlockIndex* pnextSibling{};
+
+  BlockIndex() = default;
+  BlockIndex(BlockIndex&&) = default;
+  BlockIndex& operator=(BlockIndex&&) = default;
+
+  BlockIndex(const BlockIndex& o)
+      : pprev(o.pprev),
+        pskip(o.pskip),
+        height(o.height),
+        status(o.status),
+        chainWork(o.chainWork),
+        header(o.header),
+        pfirstChild(o.pfirstChild),
+        pnextSibling(o.pnextSibling),
+        pop_(o.pop_ ? new PopData(*o.pop_) : nullptr),
+        hash_(o.hash_),
+        hasHash_(o.hasHash_) {}
+
+  BlockIndex& operator=(const BlockIndex& o) {
+    if (this != &o) {
+      BlockIndex copy(o);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
 
-  //! list of containing context blocks that **change** current state
-  context_t containingContext{};
+  //! @return POP data of this block, empty if block has none
+  const PopData& getPopData() const {
+    static const PopData empty{};
+    return pop_ ? *pop_ : empty;
+  }
 
-  //! height of the entry in the chain
-  height_t height = 0;
+  //! same as unix `touch`: create-and-get POP data if not exists, get
+  //! otherwise
+  PopData& touchPopData() {
+    if (!pop_) {
+      pop_.reset(new PopData());
+    }
+    return *pop_;
+  }
 
-  //! block header
-  std::shared_ptr<Block> header{};
+  bool hasPopData() const { return pop_ != nullptr; }
 
-  //! contains status flags
-  uint8_t status = 0;  // unknown validity
+  //! copy POP data, which is stored with the block (see toRaw), from
+  //! `stored`. Endorsements are copied too, so that they are not shared with
+  //! the index they were stored from.
+  void setStoredPopData(const BlockIndex& stored) {
+    setStoredPopData(stored, IsPopProtected<Block>{});
+  }
 
   bool isValid(enum BlockStatus upTo = BLOCK_VALID_TREE) {
     assert(!(upTo & ~BLOCK_VALID_MASK));  // Only validity flags allowed.
@@ -101,7 +212,21 @@ struct BlockIndex {
 
   void unsetFlag(enum BlockStatus s) { this->status &= ~s; }
 
-  hash_t getHash() const { return header->getHash(); }
+  //! set block header and memoize its hash. Header must not be modified after
+  //! this call.
+  void setHeader(std::shared_ptr<Block> block) {
+    auto hash = block->getHash();
+    setHeader(std::move(block), std::move(hash));
+  }
+
+  //! same as above, but with already calculated `hash` of the `block`
+  void setHeader(std::shared_ptr<Block> block, hash_t hash) {
+    header = std::move(block);
+    hash_ = std::move(hash);
+    hasHash_ = true;
+  }
+
+  hash_t getHash() const { return hasHash_ ? hash_ : header->getHash(); }
   uint32_t getBlockTime() const { return header->getBlockTime(); }
   uint32_t getDifficulty() const { return header->getDifficulty(); }
 
@@ -113,26 +238,65 @@ struct BlockIndex {
     return this->getAncestor(this->height + 1 - steps);
   }
 
+  //! build skip-list pointer. pprev and height must be set before this call.
+  void buildSkip() {
+    if (pprev != nullptr) {
+      pskip = pprev->getAncestor(getSkipHeight(height));
+    }
+  }
+
+  //! add this block to children of 'pprev'
+  void linkToPrev() {
+    if (pprev != nullptr) {
+      pnextSibling = pprev->pfirstChild;
+      pprev->pfirstChild = this;
+    }
+  }
+
+  //! remove this block from children of 'pprev'
+  void unlinkFromPrev() {
+    if (pprev == nullptr) {
+      return;
+    }
+
+    for (BlockIndex** it = &pprev->pfirstChild; *it != nullptr;
+         it = &(*it)->pnextSibling) {
+      if (*it == this) {
+        *it = pnextSibling;
+        break;
+      }
+    }
+    pnextSibling = nullptr;
+  }
+
   BlockIndex* getAncestor(height_t _height) const {
     if (_height < 0 || _height > this->height) {
       return nullptr;
     }
 
-    // TODO: this algorithm is not optimal. for O(n) seek backwards until we hit
-    // valid height. also it assumes whole blockchain is in memory (pprev is
-    // valid until given height)
+    // follow skip pointers when it does not overshoot, otherwise go to pprev.
+    // it assumes whole blockchain is in memory (pprev is valid until given
+    // height)
     BlockIndex* index = const_cast<BlockIndex*>(this);
-    while (index != nullptr) {
-      if (index->height > _height) {
-        index = index->pprev;
-      } else if (index->height == _height) {
-        return index;
+    while (index != nullptr && index->height > _height) {
+      height_t heightSkip = getSkipHeight(index->height);
+      height_t heightSkipPrev = getSkipHeight(index->height - 1);
+      if (index->pskip != nullptr &&
+          (heightSkip == _height ||
+           (heightSkip > _height && !(heightSkipPrev < heightSkip - 2 &&
+                                      heightSkipPrev >= _height)))) {
+        // only follow pskip if pprev->pskip isn't better than pskip->pprev
+        index = index->pskip;
       } else {
-        return nullptr;
+        index = index->pprev;
       }
     }
 
-    return nullptr;
+    if (index == nullptr || index->height != _height) {
+      return nullptr;
+    }
+
+    return index;
   }
 
   std::string toPrettyString(size_t level = 0) const {
@@ -140,14 +304,20 @@ struct BlockIndex {
            "BlockIndex{height=" + std::to_string(height) +
            ", hash=" + HexStr(getHash()) +
            ", prev=" + (pprev ? HexStr(pprev->getHash()) : "<empty>") +
-           ", endorsedBy=" + std::to_string(endorsedBy.size()) +
+           ", endorsedBy=" + std::to_string(getPopData().endorsedBy.size()) +
            ", containsEndorsements=" +
-           std::to_string(containingEndorsements.size()) + "}";
+           std::to_string(getPopData().containingEndorsements.size()) + "}";
   }
 
+  //! write block for storage. Record consists of version, height, status,
+  //! header and, for POP protected blocks, containing endorsements and
+  //! context. Derived data, like 'endorsedBy', is restored on load.
   void toRaw(WriteStream& stream) const {
+    stream.writeBE<uint8_t>(BLOCK_INDEX_RAW_VERSION);
     stream.writeBE<uint32_t>(height);
-    header.toRaw(stream);
+    stream.writeBE<uint8_t>(status);
+    header->toRaw(stream);
+    popDataToRaw(stream, IsPopProtected<Block>{});
   }
 
   std::vector<uint8_t> toRaw() const {
@@ -158,8 +328,27 @@ struct BlockIndex {
 
   static BlockIndex fromRaw(ReadStream& stream) {
     BlockIndex index{};
+    auto start = stream.position();
+    auto version = stream.readBE<uint8_t>();
+    if ((version & 0x80) == 0) {
+      // unversioned record has only height and header. Blocks were stored
+      // after they had been accepted.
+      stream.setPosition(start);
+      index.height = stream.readBE<uint32_t>();
+      index.setHeader(std::make_shared<Block>(Block::fromRaw(stream)));
+      index.raiseValidity(BLOCK_VALID_TREE);
+      return index;
+    }
+
+    if (version != BLOCK_INDEX_RAW_VERSION) {
+      throw std::invalid_argument("unknown BlockIndex record version " +
+                                  std::to_string(version));
+    }
+
     index.height = stream.readBE<uint32_t>();
-    index.header = Block::fromRaw(stream);
+    index.status = stream.readBE<uint8_t>();
+    index.setHeader(std::make_shared<Block>(Block::fromRaw(stream)));
+    index.popDataFromRaw(stream, IsPopProtected<Block>{});
     return index;
   }
 
@@ -175,6 +364,63 @@ struct BlockIndex {
   friend bool operator!=(const BlockIndex& a, const BlockIndex& b) {
     return !operator==(a, b);
   }
+
+ private:
+  std::unique_ptr<PopData> pop_;
+
+  //! memoized hash of the header, see setHeader
+  hash_t hash_{};
+  bool hasHash_ = false;
+
+  void popDataToRaw(WriteStream&, std::false_type) const {}
+
+  void popDataToRaw(WriteStream& stream, std::true_type) const {
+    const auto& pop = getPopData();
+    writeSingleBEValue(stream, pop.containingEndorsements.size());
+    for (const auto& e : pop.containingEndorsements) {
+      e.second->toRaw(stream);
+    }
+    pop.containingContext.toRaw(stream);
+  }
+
+  void popDataFromRaw(ReadStream&, std::false_type) {}
+
+  void popDataFromRaw(ReadStream& stream, std::true_type) {
+    auto endorsements = readArrayOf<std::shared_ptr<endorsement_t>>(
+        stream, 0, MAX_CONTEXT_COUNT, [](ReadStream& s) {
+          return std::make_shared<endorsement_t>(endorsement_t::fromRaw(s));
+        });
+    auto context = context_t::fromRaw(stream);
+    if (endorsements.empty() && context.empty()) {
+      return;
+    }
+
+    auto& pop = touchPopData();
+    for (auto& e : endorsements) {
+      auto id = e->id;
+      pop.containingEndorsements.insert({id, std::move(e)});
+    }
+    pop.containingContext = std::move(context);
+  }
+
+  void setStoredPopData(const BlockIndex&, std::false_type) {}
+
+  void setStoredPopData(const BlockIndex& stored, std::true_type) {
+    if (!stored.hasPopData()) {
+      return;
+    }
+
+    auto& pop = touchPopData();
+    for (const auto& e : stored.getPopData().containingEndorsements) {
+      auto copy = std::make_shared<endorsement_t>(*e.second);
+      copy->blockOfProofIndex = nullptr;
+      copy->blockOfProofHeight = 0;
+      copy->endorsedIndex = nullptr;
+      copy->endorsedByPosition = 0;
+      pop.containingEndorsements.insert({e.first, std::move(copy)});
+    }
+    pop.containingContext = stored.getPopData().containingContext;
+  }
 };
 
 template <typename Block>
@@ -0,0 +1,45 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_BLOCK_PROOF_CACHE_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_BLOCK_PROOF_CACHE_HPP_
+
+#include <cstdint>
+
+#include "veriblock/arith_uint256.hpp"
+#include "veriblock/blockchain/blockchain_util.hpp"
+#include "veriblock/bounded_cache.hpp"
+
+namespace altintegration {
+
+//! bounded map of difficulty bits to amount of work, which they require
+class BlockProofCache : public BoundedCache<uint32_t, ArithUint256> {
+ public:
+  using key_t = uint32_t;
+
+  static const size_t DEFAULT_MAX_SIZE = 1024;
+
+  explicit BlockProofCache(size_t maxSize = DEFAULT_MAX_SIZE)
+      : BoundedCache(maxSize) {}
+};
+
+//! same as getBlockProof, but memoized by difficulty bits of the block.
+//! Every block type has its own cache.
+template <typename Block>
+ArithUint256 getBlockProofCached(const Block& block) {
+  static BlockProofCache cache;
+
+  const uint32_t bits = block.getDifficulty();
+  ArithUint256 proof;
+  if (!cache.get(bits, proof)) {
+    proof = getBlockProof(block);
+    cache.insert(bits, proof);
+  }
+  return proof;
+}
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_BLOCK_PROOF_CACHE_HPP_
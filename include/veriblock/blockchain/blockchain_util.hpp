@@ -8,6 +8,7 @@
 
 #include <veriblock/blockchain/block_index.hpp>
 #include <veriblock/blockchain/chain.hpp>
+#include <veriblock/blockchain/chain_window.hpp>
 #include <veriblock/validation_state.hpp>
 
 namespace altintegration {
@@ -15,27 +16,54 @@ namespace altintegration {
 template <typename Block>
 void determineBestChain(Chain<Block>& currentBest, BlockIndex<Block>& indexNew);
 
+//! `window` is the window of `prevBlock`, see ChainWindow. If it is nullptr,
+//! the chain is walked instead.
 template <typename Block, typename ChainParams>
 uint32_t getNextWorkRequired(const BlockIndex<Block>& prevBlock,
                              const Block& block,
-                             const ChainParams& params);
+                             const ChainParams& params,
+                             const ChainWindow<Block>* window = nullptr);
+
+//! fill retarget data of `window` of `index`, which must be connected to its
+//! previous block already. `prev` is the window of the previous block, or
+//! nullptr if it is unknown.
+template <typename Block, typename ChainParams>
+void buildRetargetWindow(const BlockIndex<Block>& index,
+                         const ChainWindow<Block>* prev,
+                         const ChainParams& params,
+                         ChainWindow<Block>& window);
+
+//! compute window of `index` from `prev`, window of its previous block, or
+//! from the chain if `prev` is nullptr
+template <typename Block, typename ChainParams>
+ChainWindow<Block> buildChainWindow(const BlockIndex<Block>& index,
+                                    const ChainWindow<Block>* prev,
+                                    const ChainParams& params) {
+  ChainWindow<Block> window;
+  buildSortedTimes(index, prev, window);
+  buildRetargetWindow(index, prev, params, window);
+  return window;
+}
 
 template <typename Block>
 ArithUint256 getBlockProof(const Block& block);
 
 template <typename Block>
-int64_t getMedianTimePast(const BlockIndex<Block>& prev);
+int64_t getMedianTimePast(const BlockIndex<Block>& prev,
+                          const ChainWindow<Block>* window = nullptr);
 
 template <typename Block>
 bool checkBlockTime(const BlockIndex<Block>& prev,
                     const Block& block,
-                    ValidationState& state);
+                    ValidationState& state,
+                    const ChainWindow<Block>* window = nullptr);
 
 template <typename Block, typename ChainParams>
 bool contextuallyCheckBlock(const BlockIndex<Block>& prev,
                             const Block& block,
                             ValidationState& state,
-                            const ChainParams& params);
+                            const ChainParams& params,
+                            const ChainWindow<Block>* window = nullptr);
 
 template <typename BlockTree, typename BlockIndexT>
 void addContextToBlockIndex(BlockIndexT&,
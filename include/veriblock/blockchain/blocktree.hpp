@@ -8,10 +8,17 @@
 
 #include <algorithm>
 #include <memory>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <veriblock/blockchain/arena.hpp>
 #include <veriblock/blockchain/block_index.hpp>
+#include <veriblock/blockchain/block_proof_cache.hpp>
 #include <veriblock/blockchain/blockchain_util.hpp>
 #include <veriblock/blockchain/chain.hpp>
+#include <veriblock/blockchain/chain_window.hpp>
+#include <veriblock/blockchain/fork_candidates.hpp>
+#include <veriblock/blockchain/undo_log.hpp>
 #include <veriblock/stateless_validation.hpp>
 #include <veriblock/storage/block_repository.hpp>
 #include <veriblock/validation_state.hpp>
@@ -31,11 +38,8 @@ struct BlockTree {
   using prev_block_hash_t = decltype(Block::previousBlock);
   using height_t = typename Block::height_t;
   using payloads_t = typename block_t::payloads_t;
-  using block_index_t =
-      std::unordered_map<prev_block_hash_t, std::shared_ptr<index_t>>;
-  using fork_chains_t = std::multimap<typename Block::height_t,
-                                      Chain<index_t>,
-                                      std::greater<typename Block::height_t>>;
+  using block_index_t = std::unordered_map<prev_block_hash_t, index_t*>;
+  using fork_candidates_t = ForkCandidates<index_t>;
 
   virtual ~BlockTree() = default;
 
@@ -94,11 +98,9 @@ struct BlockTree {
     // apply the rest of the blocks from the chain on top of our bootstrap
     // block. disable difficulty checks, because we have not enough blocks in
     // our store (yet) to check it correctly
-    for (size_t i = 1, size = chain.size(); i < size; i++) {
-      auto& block = chain[i];
-      if (!this->acceptBlock(std::make_shared<block_t>(block), state, false)) {
-        return state.Invalid("blocktree-accept");
-      }
+    Slice<const block_t> rest(chain.data() + 1, chain.size() - 1);
+    if (!this->doAcceptBlocks(makeShared(rest), state, false, true)) {
+      return state.Invalid("blocktree-accept");
     }
 
     return true;
@@ -110,7 +112,7 @@ struct BlockTree {
   index_t* getBlockIndex(const Blob<N>& hash) const {
     auto shortHash = hash.template trimLE<prev_block_hash_t::size()>();
     auto it = valid_blocks.find(shortHash);
-    return it == valid_blocks.end() ? nullptr : it->second.get();
+    return it == valid_blocks.end() ? nullptr : it->second;
   }
 
   template <size_t N,
@@ -119,7 +121,7 @@ struct BlockTree {
   index_t* getBlockIndexFailed(const Blob<N>& hash) const {
     auto shortHash = hash.template trimLE<prev_block_hash_t::size()>();
     auto it = failed_blocks.find(shortHash);
-    return it == failed_blocks.end() ? nullptr : it->second.get();
+    return it == failed_blocks.end() ? nullptr : it->second;
   }
 
   bool acceptBlock(const block_t& block, ValidationState& state) {
@@ -131,6 +133,121 @@ struct BlockTree {
     return acceptBlock(block, state, true);
   }
 
+  /**
+   * Accept a batch of blocks.
+   *
+   * Every block must either connect to a block already known to the tree, or
+   * to one of the previous blocks in the batch. Proof of work of all blocks is
+   * checked upfront, then blocks are connected one by one. For a run of
+   * blocks which extends the active chain, fork resolution runs once for the
+   * last block of the run instead of once per block.
+   *
+   * @param checkPowInParallel whether proof of work of large batches is
+   * checked on multiple threads. Intended for headers received from the
+   * network. Fork resolution, which applies containing context of blocks on
+   * every comparison, checks it on the calling thread instead.
+   * @return true if all blocks were accepted. Otherwise, blocks before the
+   * invalid one stay in the tree, and `state` contains index of the invalid
+   * block in the batch.
+   */
+  bool acceptBlocks(Slice<const block_t> blocks,
+                    ValidationState& state,
+                    bool checkPowInParallel = true) {
+    return doAcceptBlocks(makeShared(blocks), state, true, checkPowInParallel);
+  }
+
+  bool acceptBlocks(const std::vector<std::shared_ptr<block_t>>& blocks,
+                    ValidationState& state,
+                    bool checkPowInParallel = true) {
+    return doAcceptBlocks(blocks, state, true, checkPowInParallel);
+  }
+
+  /**
+   * Restore tree from blocks, which were previously stored from another tree.
+   *
+   * Stored blocks are trusted: proof of work and contextual checks are not
+   * repeated, height, status and POP data are taken from storage. Blocks must
+   * be sorted by height, the first one is used as a bootstrap block.
+   *
+   * @param tip hash of the tip of the active chain of the stored tree. If
+   * nullptr, valid block with the most chain work becomes the tip.
+   * @return true if tree is restored, false if some block does not connect
+   * to the previous ones, or tip is not a valid block.
+   */
+  virtual bool loadBlocks(const std::vector<index_t>& blocks,
+                          const hash_t* tip,
+                          ValidationState& state) {
+    assert(valid_blocks.empty() && "already bootstrapped");
+    if (blocks.empty()) {
+      return state.Invalid("load-empty", "no blocks to load");
+    }
+
+    std::vector<index_t*> loaded;
+    loaded.reserve(blocks.size());
+    for (size_t i = 0, size = blocks.size(); i < size; i++) {
+      const auto& stored = blocks[i];
+      auto* index = insertBlockHeader(stored.header);
+      if (i == 0) {
+        index->height = stored.height;
+      } else if (index->pprev == nullptr) {
+        return state.Invalid("load-bad-prev-block",
+                             "can not find previous block for " +
+                                 HexStr(stored.getHash()));
+      }
+
+      index->status = stored.status;
+      index->setStoredPopData(stored);
+      loaded.push_back(index);
+    }
+
+    // loaded blocks are stored already
+    changed_.clear();
+
+    index_t* best = nullptr;
+    for (auto* index : loaded) {
+      if (index->pprev != nullptr && !index->pprev->isValid() &&
+          (index->status & BLOCK_FAILED_CHILD) == 0) {
+        index->setFlag(BLOCK_FAILED_CHILD);
+        changed_.insert(index);
+      }
+
+      if (!index->isValid()) {
+        doInvalidateBlock(index->getHash());
+        continue;
+      }
+
+      if (best == nullptr || best->chainWork < index->chainWork) {
+        best = index;
+      }
+    }
+
+    if (tip != nullptr) {
+      best = getBlockIndex(*tip);
+      if (best == nullptr) {
+        return state.Invalid("load-bad-tip",
+                             "tip " + HexStr(*tip) + " is not a valid block");
+      }
+    }
+    activeChain_ = Chain<index_t>(loaded[0]->height, best);
+
+    // every valid leaf outside of the active chain is a fork candidate
+    for (auto* index : loaded) {
+      if (index->isValid() && !isCoveredByActiveOrFork(index)) {
+        fork_candidates_.insert(index);
+      }
+    }
+
+    return true;
+  }
+
+  //! blocks, which were added or changed since the tree was loaded or since
+  //! the last call of clearChangedBlocks. See saveBlockTreeChanges.
+  const std::unordered_set<index_t*>& getChangedBlocks() const {
+    return changed_;
+  }
+
+  void clearChangedBlocks() { changed_.clear(); }
+
   void invalidateTip() {
     auto* tip = getBestChain().tip();
     assert(tip != nullptr && "not bootstrapped...");
@@ -143,37 +260,48 @@ struct BlockTree {
       return;
     }
 
-    std::vector<index_t*> affectedBlocks;
-    std::vector<index_t*> fork_tips;
-
-    for (auto it = fork_chains_.begin(); it != fork_chains_.end();) {
-      invalidateBlockFromChain(it->second, blockIndex, affectedBlocks);
-
-      if (it->second.tip() == nullptr) {
-        it = fork_chains_.erase(it);
-      } else {
-        fork_tips.push_back(it->second.tip());
-        ++it;
+    // invalidate block itself and all its valid descendants
+    setBlockFlag(*blockIndex, BLOCK_FAILED_BLOCK);
+    doInvalidateBlock(blockIndex->getHash());
+    std::vector<index_t*> stack{blockIndex};
+    while (!stack.empty()) {
+      auto* index = stack.back();
+      stack.pop_back();
+      for (auto* child = index->pfirstChild; child != nullptr;
+           child = child->pnextSibling) {
+        if (!child->isValid()) {
+          // whole subtree is invalid already
+          continue;
+        }
+
+        setBlockFlag(*child, BLOCK_FAILED_CHILD);
+        doInvalidateBlock(child->getHash());
+        stack.push_back(child);
       }
     }
 
-    invalidateBlockFromChain(activeChain_, blockIndex, affectedBlocks);
+    auto* tip = activeChain_.tip();
+    if (tip != nullptr && !tip->isValid()) {
+      setActiveTip(activeChain_, highestValidAncestor(tip));
+    }
 
-    // invalidate block itself
-    blockIndex->setFlag(BLOCK_FAILED_BLOCK);
+    // cut invalid blocks from fork candidates
+    for (auto* oldTip : fork_candidates_.getTips()) {
+      if (oldTip->isValid()) {
+        continue;
+      }
 
-    // invalidate all child blocks
-    for (const auto& a : affectedBlocks) {
-      a->setFlag(BLOCK_FAILED_CHILD);
-      doInvalidateBlock(a->getHash());
+      eraseForkCandidate(oldTip);
+      auto* valid = highestValidAncestor(oldTip);
+      if (valid != nullptr && !isCoveredByActiveOrFork(valid)) {
+        insertForkCandidate(valid);
+      }
     }
 
     // find new best chain among all forks
-    for (const auto& fork_tip : fork_tips) {
+    for (auto* fork_tip : fork_candidates_.getTips()) {
       determineBestChain(activeChain_, *fork_tip);
     }
-
-    doInvalidateBlock(blockIndex->getHash());
   }
 
   virtual void invalidateBlockByHash(const hash_t& blockHash) {
@@ -185,11 +313,25 @@ struct BlockTree {
 
   const block_index_t& getValidBlocks() const { return valid_blocks; }
   const block_index_t& getFailedBlocks() const { return failed_blocks; }
-  const fork_chains_t& getForkChains() const { return fork_chains_; }
+  const fork_candidates_t& getForkCandidates() const {
+    return fork_candidates_;
+  }
+
+  //! @return true and write window of `index` to `out`, if it is known. See
+  //! ChainWindow.
+  bool getChainWindow(const index_t& index, ChainWindow<Block>& out) const {
+    return windows_->get(index.getHash(), out);
+  }
+
+  //! attach journal, which records every mutation of this tree, so that it
+  //! can be reverted with UndoLog::rollback. Pass nullptr to detach.
+  virtual void setUndoLog(UndoLog* log) { undo_.reset(log); }
+  UndoLog* getUndoLog() const { return undo_.get(); }
 
   bool operator==(const BlockTree& o) const {
     return valid_blocks == o.valid_blocks && failed_blocks == o.failed_blocks &&
-           activeChain_ == o.activeChain_ && fork_chains_ == o.fork_chains_;
+           activeChain_ == o.activeChain_ &&
+           fork_candidates_ == o.fork_candidates_;
   }
 
   std::string toPrettyString(size_t level = 0) const {
@@ -208,33 +350,35 @@ struct BlockTree {
       s << b.second->toPrettyString(level + 2) << "\n";
     }
     s << pad << "}\n" << pad << "{forktips=\n";
-    for (const auto& f : fork_chains_) {
-      s << f.second.tip()->toPrettyString(level + 2) << "\n";
+    for (const auto& f : fork_candidates_) {
+      s << f.second->toPrettyString(level + 2) << "\n";
     }
     s << pad << "}";
     return s.str();
   }
 
  protected:
+  //! owns all block indices of the tree. Shared with copies of this tree,
+  //! because they refer to same block indices
+  std::shared_ptr<Arena<index_t>> arena_ = std::make_shared<Arena<index_t>>();
+  //! windows of recently added blocks. Shared with copies of this tree, since
+  //! window of a block does not depend on the tree.
+  std::shared_ptr<ChainWindows<Block>> windows_ =
+      std::make_shared<ChainWindows<Block>>(CHAIN_WINDOWS_SIZE);
   block_index_t valid_blocks;
   block_index_t failed_blocks;
-
-  // first we have to analyze the highest forks, to avoid the removing blocks
-  // that can be proceed by another fork chain like in the situation described
-  // below
-  // We have two fork chains that one of the fork chain has been forked from
-  // another
-  //  F - G - H - I
-  //      \ Q
-  // and if block F is being removed, and chain 'F - G - H - I' will be
-  // processed firstly, we will remove block 'G' which is needed for the
-  // another chain, so that chain must be processed firstly
-
-  fork_chains_t fork_chains_;
+  //! tips of valid forks. Every valid block, which is not on the active
+  //! chain, is an ancestor of one of these tips (or a tip itself)
+  fork_candidates_t fork_candidates_;
   Chain<index_t> activeChain_;
 
   const ChainParams* param_ = nullptr;
 
+  UndoLogRef undo_;
+
+  //! see getChangedBlocks
+  std::unordered_set<index_t*> changed_;
+
   void doInvalidateBlock(const hash_t& hash) {
     auto shortHash = hash.template trimLE<prev_block_hash_t::size()>();
     auto it = valid_blocks.find(shortHash);
@@ -242,21 +386,114 @@ struct BlockTree {
       return;
     }
 
-    failed_blocks[shortHash] = it->second;
+    auto& failed = failed_blocks[shortHash];
+    if (undo_) {
+      index_t* moved = it->second;
+      index_t* overwritten = failed;
+      undo_.record([this, shortHash, moved, overwritten]() {
+        valid_blocks[shortHash] = moved;
+        if (overwritten) {
+          failed_blocks[shortHash] = overwritten;
+        } else {
+          failed_blocks.erase(shortHash);
+        }
+      });
+    }
+
+    failed = it->second;
     valid_blocks.erase(it);
   }
 
+  void setBlockFlag(index_t& index, enum BlockStatus flag) {
+    auto* ptr = &index;
+    auto status = index.status;
+    undo_.record([ptr, status]() { ptr->status = status; });
+    index.setFlag(flag);
+    changed_.insert(ptr);
+  }
+
+  //! change tip of the active chain
+  void setActiveTip(Chain<index_t>& chain, index_t* tip) {
+    assert(&chain == &activeChain_);
+    auto* oldTip = chain.tip();
+    undo_.record([this, oldTip]() { activeChain_.setTip(oldTip); });
+    chain.setTip(tip);
+  }
+
+  void insertForkCandidate(index_t* tip) {
+    if (fork_candidates_.insert(tip)) {
+      undo_.record([this, tip]() { fork_candidates_.erase(tip); });
+    }
+  }
+
+  void eraseForkCandidate(index_t* tip) {
+    uint64_t sequence = 0;
+    if (tip != nullptr && fork_candidates_.erase(tip, &sequence)) {
+      undo_.record(
+          [this, tip, sequence]() { fork_candidates_.insert(tip, sequence); });
+    }
+  }
+
+  //! @return true if `index` is on the active chain, or is a fork candidate,
+  //! or is an ancestor of a fork candidate
+  bool isCoveredByActiveOrFork(index_t* index) const {
+    if (activeChain_.contains(index) || fork_candidates_.contains(index)) {
+      return true;
+    }
+
+    // every valid block outside of active chain leads to a fork candidate
+    for (auto* child = index->pfirstChild; child != nullptr;
+         child = child->pnextSibling) {
+      if (child->isValid()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   //! same as unix `touch`: create-and-get if not exists, get otherwise
   index_t* touchBlockIndex(const hash_t& fullHash) {
     auto hash = fullHash.template trimLE<prev_block_hash_t::size()>();
     auto it = valid_blocks.find(hash);
     if (it != valid_blocks.end()) {
-      return it->second.get();
+      return it->second;
+    }
+
+    releaseDeferredBlocks();
+    auto* newIndex = arena_->create();
+    valid_blocks.insert({hash, newIndex});
+    changed_.insert(newIndex);
+    undo_.record([this, hash, newIndex]() {
+      valid_blocks.erase(hash);
+      changed_.erase(newIndex);
+      if (arena_.use_count() == 1) {
+        arena_->release(newIndex);
+      } else {
+        // copies of this tree may still refer to the block. It is released
+        // by releaseDeferredBlocks, once this tree is the only owner of the
+        // arena.
+        arena_->defer(newIndex);
+      }
+    });
+    return newIndex;
+  }
+
+  //! release blocks, which were rolled back while the arena was shared with
+  //! copies of this tree, if copies are gone and this tree does not use them
+  void releaseDeferredBlocks() {
+    if (arena_.use_count() > 1 || !arena_->hasDeferred()) {
+      return;
     }
 
-    auto newIndex = std::make_shared<index_t>();
-    it = valid_blocks.insert({hash, std::move(newIndex)}).first;
-    return it->second.get();
+    arena_->releaseDeferred([this](const index_t& index) {
+      if (index.header == nullptr) {
+        return false;
+      }
+
+      auto hash = index.getHash();
+      return getBlockIndex(hash) == &index ||
+             getBlockIndexFailed(hash) == &index;
+    });
   }
 
   index_t* insertBlockHeader(const std::shared_ptr<block_t>& block) {
@@ -268,119 +505,183 @@ struct BlockTree {
     }
 
     current = touchBlockIndex(hash);
-    current->header = block;
+    current->setHeader(block, hash);
     current->pprev = getBlockIndex(block->previousBlock);
 
     if (current->pprev) {
       // prev block found
       current->height = current->pprev->height + 1;
-      current->chainWork = current->pprev->chainWork + getBlockProof(*block);
+      current->chainWork =
+          current->pprev->chainWork + getBlockProofCached(*block);
     } else {
       current->height = 0;
-      current->chainWork = getBlockProof(*block);
+      current->chainWork = getBlockProofCached(*block);
     }
 
+    current->buildSkip();
+    addChainWindow(*current);
+    current->linkToPrev();
+    undo_.record([current]() { current->unlinkFromPrev(); });
     current->raiseValidity(BLOCK_VALID_TREE);
 
     return current;
   }
 
-  void invalidateBlockFromChain(Chain<index_t>& chain,
-                                const index_t* block,
-                                std::vector<index_t*>& affectedBlocks) {
-    if (block == nullptr) {
-      return;
+  //! remember window of `index`, derived from the window of its previous block
+  void addChainWindow(const index_t& index) {
+    ChainWindow<Block> prev;
+    bool hasPrev = index.pprev != nullptr && getChainWindow(*index.pprev, prev);
+    auto window = buildChainWindow(index, hasPrev ? &prev : nullptr, *param_);
+    windows_->insert(index.getHash(), window);
+  }
+
+  //! @return `index` or its highest ancestor, which is not invalid
+  static index_t* highestValidAncestor(index_t* index) {
+    while (index != nullptr && !index->isValid()) {
+      index = index->pprev;
     }
+    return index;
+  }
 
-    if (!chain.contains(block) &&
-        !(activeChain_.contains(block) &&
-          block->height < chain.first()->height) &&
-        chain.first()->getAncestor(block->height) != block) {
+  void addForkCandidate(BlockIndex<Block>* newCandidate,
+                        BlockIndex<Block>* oldCandidate) {
+    if (newCandidate == nullptr) {
       return;
     }
 
-    while (chain.tip() != nullptr && chain.tip() != block) {
-      affectedBlocks.push_back(chain.tip());
-      disconnectTipFromChain(chain);
+    // fork, which ends at the parent of the new candidate, is extended
+    eraseForkCandidate(newCandidate->pprev);
+
+    // old candidate is on the active chain now
+    if (oldCandidate != nullptr) {
+      eraseForkCandidate(oldCandidate);
+      eraseForkCandidate(oldCandidate->pprev);
     }
 
-    // disconnect the block from the current chain, but do not remove it from
-    // block_index_
-    if (chain.tip() != nullptr) {
-      chain.disconnectTip();
+    if (!isCoveredByActiveOrFork(newCandidate)) {
+      insertForkCandidate(newCandidate);
     }
   }
 
-  void disconnectTipFromChain(Chain<index_t>& chain) {
-    BlockIndex<Block>* currentTip = chain.tip();
-    hash_t tipHash = currentTip->getHash();
+  bool acceptBlock(const std::shared_ptr<block_t>& block,
+                   ValidationState& state,
+                   bool shouldContextuallyCheck) {
+    index_t* index = nullptr;
+    if (!validateAndAddBlock(block, state, shouldContextuallyCheck, &index)) {
+      return false;
+    }
+
+    bool isBootstrap = !shouldContextuallyCheck;
+    determineBestChain(activeChain_, *index, isBootstrap);
+
+    return true;
+  }
 
-    chain.disconnectTip();
-    doInvalidateBlock(tipHash);
+  static std::vector<std::shared_ptr<block_t>> makeShared(
+      Slice<const block_t> blocks) {
+    std::vector<std::shared_ptr<block_t>> ret;
+    ret.reserve(blocks.size());
+    for (const auto& block : blocks) {
+      ret.push_back(std::make_shared<block_t>(block));
+    }
+    return ret;
   }
 
-  void addForkCandidate(BlockIndex<Block>* newCandidate,
-                        BlockIndex<Block>* oldCandidate) {
-    if (newCandidate == nullptr) {
-      return;
+  bool doAcceptBlocks(const std::vector<std::shared_ptr<block_t>>& ptrs,
+                      ValidationState& state,
+                      bool shouldContextuallyCheck,
+                      bool checkPowInParallel) {
+    if (ptrs.empty()) {
+      return true;
     }
 
-    bool isAdded = false;
-    auto forkChainStart = fork_chains_.end();
-    for (auto chain_it = fork_chains_.begin();
-         chain_it != fork_chains_.end();) {
-      if (chain_it->second.tip() == newCandidate->pprev) {
-        chain_it->second.setTip(newCandidate);
-        isAdded = true;
-      }
+    // the most expensive part of header validation is PoW, and it does not
+    // depend on the tree, so it is done for the whole batch upfront
+    auto isPowValid = checkBlocks(ptrs, checkPowInParallel);
 
-      if (chain_it->second.contains(newCandidate)) {
-        isAdded = true;
+    bool isBootstrap = !shouldContextuallyCheck;
+    // last connected block, for which fork resolution is not done yet
+    index_t* pending = nullptr;
+    auto resolvePending = [&]() {
+      if (pending != nullptr) {
+        determineBestChain(activeChain_, *pending, isBootstrap);
+        pending = nullptr;
+      }
+    };
+
+    for (size_t i = 0, size = ptrs.size(); i < size; i++) {
+      if (!isPowValid[i]) {
+        resolvePending();
+        // repeat the check to fill in the validation state
+        checkBlock(*ptrs[i], state, *param_);
+        state.Invalid("check-block");
+        return state.Invalid("blocktree-accept-blocks", i);
       }
 
-      if (chain_it->second.contains(newCandidate->pprev)) {
-        forkChainStart = chain_it;
+      index_t* index = nullptr;
+      if (!addBlock(ptrs[i], state, shouldContextuallyCheck, &index)) {
+        resolvePending();
+        return state.Invalid("blocktree-accept-blocks", i);
       }
 
-      if (chain_it->second.tip() == oldCandidate ||
-          (oldCandidate != nullptr &&
-           chain_it->second.tip() == oldCandidate->pprev)) {
-        chain_it = fork_chains_.erase(chain_it);
+      if (pending == nullptr && index->pprev != activeChain_.tip()) {
+        // block is on a fork. Resolve it right away, so that fork chains are
+        // built the same way as when blocks are accepted one by one
+        determineBestChain(activeChain_, *index, isBootstrap);
         continue;
       }
-      ++chain_it;
-    }
-
-    if (activeChain_.contains(newCandidate) || isAdded) {
-      return;
-    }
 
-    // find block from the main chain
-    index_t* workBlock = newCandidate;
-    if (forkChainStart == fork_chains_.end()) {
-      for (; !activeChain_.contains(workBlock->pprev);
-           workBlock = workBlock->pprev)
-        ;
+      // block extends active chain. If it is extended by the next block in
+      // the batch, it can not be a better tip than its descendant
+      pending = index;
+      if (i + 1 == size ||
+          getBlockIndex(ptrs[i + 1]->previousBlock) != index) {
+        resolvePending();
+      }
     }
 
-    Chain<index_t> newForkChain(workBlock->height, workBlock);
-    newForkChain.setTip(newCandidate);
-    fork_chains_.insert(std::pair<typename Block::height_t, Chain<index_t>>(
-        newForkChain.getStartHeight(), newForkChain));
+    return true;
   }
 
-  bool acceptBlock(const std::shared_ptr<block_t>& block,
-                   ValidationState& state,
-                   bool shouldContextuallyCheck) {
-    index_t* index = nullptr;
-    if (!validateAndAddBlock(block, state, shouldContextuallyCheck, &index)) {
-      return false;
+  //! @param parallel whether large batches are split across threads
+  //! @return for every block, whether its proof of work is valid
+  std::vector<char> checkBlocks(
+      const std::vector<std::shared_ptr<block_t>>& blocks,
+      bool parallel) const {
+    // spawning threads is only worth it for large batches
+    static const size_t MIN_BLOCKS_PER_THREAD = 64;
+
+    static const size_t CORES =
+        std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    const size_t size = blocks.size();
+    std::vector<char> ret(size, 0);
+    auto checkRange = [&](size_t begin, size_t end) {
+      ValidationState dummy;
+      for (size_t i = begin; i < end; i++) {
+        ret[i] = checkBlock(*blocks[i], dummy, *param_);
+      }
+    };
+
+    const size_t threads =
+        parallel ? std::min(CORES, size / MIN_BLOCKS_PER_THREAD) : 1;
+    if (threads <= 1) {
+      checkRange(0, size);
+      return ret;
     }
 
-    bool isBootstrap = !shouldContextuallyCheck;
-    determineBestChain(activeChain_, *index, isBootstrap);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    const size_t chunk = (size + threads - 1) / threads;
+    for (size_t begin = chunk; begin < size; begin += chunk) {
+      workers.emplace_back(checkRange, begin, std::min(begin + chunk, size));
+    }
+    checkRange(0, std::min(chunk, size));
+    for (auto& worker : workers) {
+      worker.join();
+    }
 
-    return true;
+    return ret;
   }
 
   bool bootstrap(height_t height,
@@ -416,6 +717,14 @@ struct BlockTree {
       return state.Invalid("check-block");
     }
 
+    return addBlock(block, state, shouldContextuallyCheck, ret);
+  }
+
+  //! same as validateAndAddBlock, but assumes that PoW is already checked
+  bool addBlock(const std::shared_ptr<block_t>& block,
+                ValidationState& state,
+                bool shouldContextuallyCheck,
+                index_t** ret) {
     // we must know previous block
     auto* prev = getBlockIndex(block->previousBlock);
     if (prev == nullptr) {
@@ -426,9 +735,13 @@ struct BlockTree {
       }
     }
 
-    if (shouldContextuallyCheck &&
-        !contextuallyCheckBlock(*prev, *block, state, *param_)) {
-      return state.Invalid("contextually-check-block");
+    if (shouldContextuallyCheck) {
+      ChainWindow<Block> window;
+      bool hasWindow = getChainWindow(*prev, window);
+      if (!contextuallyCheckBlock(
+              *prev, *block, state, *param_, hasWindow ? &window : nullptr)) {
+        return state.Invalid("contextually-check-block");
+      }
     }
 
     auto index = insertBlockHeader(block);
@@ -441,7 +754,7 @@ struct BlockTree {
 
     // if prev block is invalid, mark this block as invalid
     if (!prev->isValid(BLOCK_VALID_TREE)) {
-      index->setFlag(BLOCK_FAILED_CHILD);
+      setBlockFlag(*index, BLOCK_FAILED_CHILD);
       // this block has to be moved to 'failed_blocks' map
       doInvalidateBlock(index->getHash());
       return state.Invalid("bad-chain", "One of previous blocks is invalid");
@@ -460,7 +773,7 @@ struct BlockTree {
     if (currentBest.tip() == nullptr ||
         currentBest.tip()->chainWork < indexNew.chainWork) {
       auto prevTip = currentBest.tip();
-      currentBest.setTip(&indexNew);
+      setActiveTip(currentBest, &indexNew);
       onTipChanged(indexNew, isBootstrap);
       addForkCandidate(prevTip, &indexNew);
     } else {
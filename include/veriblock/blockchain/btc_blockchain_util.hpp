@@ -17,28 +17,40 @@ namespace altintegration {
 template <>
 uint32_t getNextWorkRequired(const BlockIndex<BtcBlock>& prevBlock,
                              const BtcBlock& block,
-                             const BtcChainParams& params);
+                             const BtcChainParams& params,
+                             const ChainWindow<BtcBlock>* window);
+
+template <>
+void buildRetargetWindow(const BlockIndex<BtcBlock>& index,
+                         const ChainWindow<BtcBlock>* prev,
+                         const BtcChainParams& params,
+                         ChainWindow<BtcBlock>& window);
 
 template <>
 BtcBlock Miner<BtcBlock, BtcChainParams>::getBlockTemplate(
-    const BlockIndex<BtcBlock>& tip, const merkle_t& merkle);
+    const BlockIndex<BtcBlock>& tip,
+    const merkle_t& merkle,
+    const ChainWindow<BtcBlock>* window);
 
 template <>
 ArithUint256 getBlockProof(const BtcBlock& block);
 
 template <>
-int64_t getMedianTimePast(const BlockIndex<BtcBlock>& prev);
+int64_t getMedianTimePast(const BlockIndex<BtcBlock>& prev,
+                          const ChainWindow<BtcBlock>* window);
 
 template <>
 bool checkBlockTime(const BlockIndex<BtcBlock>& prev,
                     const BtcBlock& block,
-                    ValidationState& state);
+                    ValidationState& state,
+                    const ChainWindow<BtcBlock>* window);
 
 template <>
 bool contextuallyCheckBlock(const BlockIndex<BtcBlock>& prev,
                             const BtcBlock& block,
                             ValidationState& state,
-                            const BtcChainParams& params);
+                            const BtcChainParams& params,
+                            const ChainWindow<BtcBlock>* window);
 
 }  // namespace altintegration
 
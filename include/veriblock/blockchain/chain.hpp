@@ -6,6 +6,7 @@
 #ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_HPP_
 #define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_HPP_
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <unordered_set>
@@ -88,11 +89,13 @@ struct Chain {
   void setTip(index_t* index) {
     if (index == nullptr || index->height < startHeight_) {
       chain.clear();
+      invalidateMaxTime(0);
       return;
     }
 
     height_t innerHeight = toInnerHeight(index->height);
     chain.resize(innerHeight + 1);
+    invalidateMaxTime(innerHeight + 1);
 
     /// TODO: may stuck here forever when fed with malformed data
     while (true) {
@@ -103,9 +106,13 @@ struct Chain {
       chain[innerHeight] = index;
       index = index->pprev;
     }
+    invalidateMaxTime(innerHeight);
   }
 
-  void disconnectTip() { chain.pop_back(); }
+  void disconnectTip() {
+    chain.pop_back();
+    invalidateMaxTime(chain.size());
+  }
 
   friend bool operator==(const Chain& a, const Chain& b) {
     // sizes may vary, so compare tips
@@ -155,6 +162,40 @@ struct Chain {
     return ret;
   }
 
+  //! @return first block at or after `height` with block time greater than
+  //! `time`, or nullptr if there is no such block.
+  //! @note uses running maximum of block times, so it is O(log n) unless times
+  //! of blocks before `height` are already greater than `time`.
+  index_t* findFirstBlockWithTimeAfter(height_t height, uint32_t time) const {
+    height = std::max(height, startHeight_);
+    if (height > chainHeight()) {
+      return nullptr;
+    }
+
+    updateMaxTime();
+    auto begin = maxTime_.begin() + toInnerHeight(height);
+    auto it = std::upper_bound(begin, maxTime_.end(), time);
+    if (it == maxTime_.end()) {
+      return nullptr;
+    }
+
+    size_t innerHeight = it - maxTime_.begin();
+    if (it != begin || innerHeight == 0 || maxTime_[innerHeight - 1] <= time) {
+      // block at 'it' sets new maximum, so its time is greater than 'time',
+      // and times of all blocks between 'height' and 'it' are not
+      return chain[innerHeight];
+    }
+
+    // maximum is set by some block before 'height'
+    for (; innerHeight < chain.size(); innerHeight++) {
+      if (chain[innerHeight]->getBlockTime() > time) {
+        return chain[innerHeight];
+      }
+    }
+
+    return nullptr;
+  }
+
   index_t* findBlockContainingEndorsement(
       const typename index_t::endorsement_t& e,
       const uint32_t& endorsement_settlement_interval) {
@@ -164,7 +205,7 @@ struct Chain {
                              workBlock && workBlock->height >= startHeight_ &&
                              e.endorsedHash != workBlock->getHash();
          count++) {
-      if (workBlock->containingEndorsements.count(e.id)) {
+      if (workBlock->getPopData().containingEndorsements.count(e.id)) {
         return workBlock;
       }
       workBlock = workBlock->pprev;
@@ -177,6 +218,25 @@ struct Chain {
   height_t startHeight_ = 0;
   std::vector<index_t*> chain{};
 
+  //! running maximum of block times, valid for first `maxTimeValid_` blocks.
+  //! Built lazily by findFirstBlockWithTimeAfter.
+  mutable std::vector<uint32_t> maxTime_{};
+  mutable size_t maxTimeValid_ = 0;
+
+  void invalidateMaxTime(size_t innerHeight) {
+    maxTimeValid_ = std::min(maxTimeValid_, innerHeight);
+  }
+
+  void updateMaxTime() const {
+    maxTime_.resize(chain.size());
+    for (; maxTimeValid_ < chain.size(); maxTimeValid_++) {
+      uint32_t time = chain[maxTimeValid_]->getBlockTime();
+      maxTime_[maxTimeValid_] =
+          maxTimeValid_ == 0 ? time
+                             : std::max(maxTime_[maxTimeValid_ - 1], time);
+    }
+  }
+
   height_t toInnerHeight(height_t in) const {
     assert(in >= startHeight_);
     return in - startHeight_;
@@ -0,0 +1,157 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_VIEW_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_VIEW_HPP_
+
+#include <cstdint>
+#include <iterator>
+#include <veriblock/blockchain/block_index.hpp>
+#include <veriblock/keystone_util.hpp>
+
+namespace altintegration {
+
+/**
+ * Non-owning view of a chain, which ends at given tip and starts at given
+ * height.
+ *
+ * Unlike Chain, it does not store blocks. Lookups by height follow skip-list
+ * pointers of the tip, so creating a view is O(1) and every lookup is
+ * O(log n). Useful for short-lived chains, which are queried only a few
+ * times.
+ *
+ * @tparam BlockIndexT block index type
+ */
+template <typename BlockIndexT>
+struct ChainView {
+  using index_t = BlockIndexT;
+  using block_t = typename index_t::block_t;
+  using height_t = typename block_t::height_t;
+
+  //! iterates blocks from first to tip
+  struct iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = index_t*;
+    using difference_type = std::ptrdiff_t;
+    using pointer = index_t**;
+    using reference = index_t*;
+
+    iterator(const ChainView* view, height_t height)
+        : view_(view), height_(height) {}
+
+    index_t* operator*() const { return (*view_)[height_]; }
+
+    iterator& operator++() {
+      ++height_;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator copy = *this;
+      ++height_;
+      return copy;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.height_ == b.height_;
+    }
+
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return !(a == b);
+    }
+
+   private:
+    const ChainView* view_;
+    height_t height_;
+  };
+
+  ChainView() = default;
+
+  ChainView(height_t startHeight, index_t* tip)
+      : startHeight_(startHeight),
+        tip_(tip != nullptr && tip->height >= startHeight ? tip : nullptr) {}
+
+  height_t getStartHeight() const { return startHeight_; }
+
+  index_t* tip() const { return tip_; }
+
+  index_t* first() const { return (*this)[startHeight_]; }
+
+  bool empty() const { return tip_ == nullptr; }
+
+  height_t chainHeight() const {
+    return tip_ == nullptr ? startHeight_ - 1 : tip_->height;
+  }
+
+  size_t blocksCount() const { return chainHeight() - startHeight_ + 1; }
+
+  index_t* operator[](height_t height) const {
+    if (tip_ == nullptr || height < startHeight_) {
+      return nullptr;
+    }
+
+    return tip_->getAncestor(height);
+  }
+
+  bool contains(const index_t* index) const {
+    return index != nullptr && (*this)[index->height] == index;
+  }
+
+  index_t* next(const index_t* index) const {
+    if (!contains(index)) {
+      return nullptr;
+    }
+    return (*this)[index->height + 1];
+  }
+
+  iterator begin() const { return iterator(this, startHeight_); }
+  iterator end() const { return iterator(this, chainHeight() + 1); }
+
+  //! @return last common block of this chain and chain ending at `pindex`
+  index_t* findFork(const index_t* pindex) const {
+    if (pindex == nullptr || tip_ == nullptr) {
+      return nullptr;
+    }
+
+    const index_t* a = tip_;
+    const index_t* b = pindex;
+    if (a->height > b->height) {
+      a = a->getAncestor(b->height);
+    } else if (b->height > a->height) {
+      b = b->getAncestor(a->height);
+    }
+
+    while (a != b && a != nullptr && b != nullptr &&
+           a->height > startHeight_) {
+      a = a->pprev;
+      b = b->pprev;
+    }
+
+    if (a != b || a == nullptr || a->height < startHeight_) {
+      return nullptr;
+    }
+
+    return const_cast<index_t*>(a);
+  }
+
+  //! same as findFork, but returns first keystone block at or before fork point
+  index_t* findHighestKeystoneAtOrBeforeFork(const index_t* pindex,
+                                             int ki) const {
+    auto* fork = findFork(pindex);
+    if (fork == nullptr) {
+      return nullptr;
+    }
+    auto keystoneHeight = highestKeystoneAtOrBefore(fork->height, ki);
+    return (*this)[keystoneHeight];
+  }
+
+ private:
+  height_t startHeight_ = 0;
+  index_t* tip_ = nullptr;
+};
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_VIEW_HPP_
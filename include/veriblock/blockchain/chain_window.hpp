@@ -0,0 +1,165 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_WINDOW_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_WINDOW_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "veriblock/arith_uint256.hpp"
+#include "veriblock/blockchain/block_index.hpp"
+#include "veriblock/bounded_cache.hpp"
+#include "veriblock/consts.hpp"
+#include "veriblock/entities/btcblock.hpp"
+#include "veriblock/entities/vbkblock.hpp"
+
+namespace altintegration {
+
+//! number of last blocks, which timestamps are used to calculate median time
+//! past. 0 if blocks of given type have no such rule.
+template <typename Block>
+struct MedianTimeSpan : std::integral_constant<size_t, 0> {};
+
+template <>
+struct MedianTimeSpan<BtcBlock>
+    : std::integral_constant<size_t, BTC_MEDIAN_TIME_SPAN> {};
+
+template <>
+struct MedianTimeSpan<VbkBlock>
+    : std::integral_constant<size_t, HISTORY_FOR_TIMESTAMP_AVERAGE> {};
+
+//! data of last blocks, which getNextWorkRequired needs to compute work
+//! required for children of a block. Empty if blocks of given type need none.
+template <typename Block>
+struct RetargetWindow {};
+
+//! BTC networks with min difficulty blocks reuse difficulty of the last block,
+//! which is not mined under special min difficulty rule
+template <>
+struct RetargetWindow<BtcBlock> {
+  //! difficulty of this block, or of the last block before it, which is not
+  //! a min difficulty block
+  uint32_t lastNonMinDifficulty = 0;
+};
+
+//! VBK retargets on every block, using solve times and targets of last
+//! getRetargetPeriod() blocks
+template <>
+struct RetargetWindow<VbkBlock> {
+  //! number of solve times in the window
+  uint32_t count = 0;
+  //! sum of solve times in the window, weighted from 1 for the oldest up to
+  //! getRetargetPeriod() - 1 for the newest
+  int32_t weightedSolveTime = 0;
+  //! sum of solve times in the window
+  int32_t solveTime = 0;
+  //! sum of targets of previous blocks of blocks in the window
+  ArithUint256 target = 0;
+};
+
+/**
+ * Data of last blocks of the chain, which ends at some block, that contextual
+ * checks of children of the block need.
+ *
+ * Window of a block is derived from the window of its previous block, without
+ * walking the chain. Windows are not part of BlockIndex: block trees keep them
+ * for recently added blocks only, see ChainWindows, and checks walk the chain
+ * when window of a block is unknown.
+ */
+template <typename Block>
+struct ChainWindow {
+  //! timestamps of the block and its predecessors in ascending order, see
+  //! MedianTimeSpan
+  std::array<uint32_t, MedianTimeSpan<Block>::value> sortedTimes{};
+  uint8_t sortedTimesSize = 0;
+
+  RetargetWindow<Block> retarget{};
+};
+
+//! number of recently added blocks, which windows a block tree keeps
+constexpr const size_t CHAIN_WINDOWS_SIZE = 1000;
+
+//! windows of recently added blocks by their hashes. Window of a block depends
+//! on the block and its ancestors only, so it never becomes stale.
+template <typename Block>
+using ChainWindows = BoundedCache<typename Block::hash_t, ChainWindow<Block>>;
+
+//! write sorted timestamps of `index` and its predecessors to `out`
+//! @return number of written timestamps
+template <typename Block>
+size_t collectSortedTimes(const BlockIndex<Block>& index, uint32_t* out) {
+  size_t size = 0;
+  for (const BlockIndex<Block>* it = &index;
+       it != nullptr && size < MedianTimeSpan<Block>::value;
+       it = it->pprev) {
+    out[size++] = it->getBlockTime();
+  }
+  std::sort(out, out + size);
+  return size;
+}
+
+//! fill sorted timestamps of `window` of `index` in O(span). Window of the
+//! previous block is taken from `prev`, or collected from the chain if it is
+//! nullptr.
+template <typename Block>
+void buildSortedTimes(const BlockIndex<Block>& index,
+                      const ChainWindow<Block>* prev,
+                      ChainWindow<Block>& window) {
+  using height_t = typename Block::height_t;
+  const size_t span = MedianTimeSpan<Block>::value;
+  auto* begin = window.sortedTimes.data();
+  if (span == 0) {
+    return;
+  }
+
+  if (index.pprev == nullptr || prev == nullptr) {
+    window.sortedTimesSize = (uint8_t)collectSortedTimes(index, begin);
+    return;
+  }
+
+  window.sortedTimes = prev->sortedTimes;
+  size_t size = prev->sortedTimesSize;
+  if (size == span) {
+    // timestamp of the oldest block leaves the window
+    const auto* pprev = index.pprev;
+    auto* oldest = pprev->getAncestor(pprev->height - height_t(span - 1));
+    if (oldest == nullptr) {
+      window.sortedTimesSize = (uint8_t)collectSortedTimes(index, begin);
+      return;
+    }
+    auto* it = std::lower_bound(begin, begin + size, oldest->getBlockTime());
+    std::copy(it + 1, begin + size, it);
+    --size;
+  }
+
+  auto time = index.getBlockTime();
+  auto* pos = std::upper_bound(begin, begin + size, time);
+  std::copy_backward(pos, begin + size, begin + size + 1);
+  *pos = time;
+  window.sortedTimesSize = uint8_t(size + 1);
+}
+
+//! @return timestamp at position `select(size)` among `size` sorted
+//! timestamps of `index` and its predecessors. `window` is the window of
+//! `index`, timestamps are collected from the chain if it is nullptr.
+template <typename Block, typename Select>
+uint32_t getSortedTime(const BlockIndex<Block>& index,
+                       const ChainWindow<Block>* window,
+                       Select&& select) {
+  if (window != nullptr) {
+    return window->sortedTimes[select(size_t(window->sortedTimesSize))];
+  }
+
+  std::array<uint32_t, MedianTimeSpan<Block>::value> times;
+  size_t size = collectSortedTimes(index, times.data());
+  return times[select(size)];
+}
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_CHAIN_WINDOW_HPP_
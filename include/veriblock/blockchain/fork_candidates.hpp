@@ -0,0 +1,138 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_FORK_CANDIDATES_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_FORK_CANDIDATES_HPP_
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <veriblock/arith_uint256.hpp>
+
+namespace altintegration {
+
+/**
+ * Tips of valid forks, which are not part of the active chain.
+ *
+ * Tips are ordered by chain work, most work first. Tips with equal work are
+ * ordered by the time they were added, so that the first seen fork wins a
+ * tie. Insertion, removal and lookup of a tip are O(log n).
+ *
+ * @tparam BlockIndexT block index type
+ */
+template <typename BlockIndexT>
+struct ForkCandidates {
+  using index_t = BlockIndexT;
+
+  struct Key {
+    ArithUint256 chainWork;
+    uint64_t sequence;
+
+    bool operator<(const Key& o) const {
+      if (chainWork > o.chainWork) {
+        return true;
+      }
+      if (chainWork < o.chainWork) {
+        return false;
+      }
+      return sequence < o.sequence;
+    }
+  };
+
+  using tips_t = std::map<Key, index_t*>;
+  using const_iterator = typename tips_t::const_iterator;
+
+  //! @return true if `tip` was added, false if it is a candidate already
+  bool insert(index_t* tip) { return insert(tip, nextSequence_); }
+
+  //! same as above, but restores `tip` with given sequence number
+  bool insert(index_t* tip, uint64_t sequence) {
+    if (!sequences_.emplace(tip, sequence).second) {
+      return false;
+    }
+
+    tips_.emplace(Key{tip->chainWork, sequence}, tip);
+    if (sequence >= nextSequence_) {
+      nextSequence_ = sequence + 1;
+    }
+    return true;
+  }
+
+  //! @return false if `tip` is not a candidate. Otherwise, removes it and
+  //! writes its sequence number to `sequence`, if not nullptr
+  bool erase(const index_t* tip, uint64_t* sequence = nullptr) {
+    auto it = sequences_.find(tip);
+    if (it == sequences_.end()) {
+      return false;
+    }
+
+    if (sequence != nullptr) {
+      *sequence = it->second;
+    }
+    tips_.erase(Key{tip->chainWork, it->second});
+    sequences_.erase(it);
+    return true;
+  }
+
+  bool contains(const index_t* tip) const { return sequences_.count(tip) != 0; }
+
+  //! @return candidates, which are `index` itself or its descendants, in
+  //! order of iteration. Only tips with at least as much work as `index` are
+  //! examined.
+  std::vector<index_t*> getDescendantsOf(const index_t& index) const {
+    std::vector<index_t*> ret;
+    for (const auto& tip : tips_) {
+      auto* candidate = tip.second;
+      if (candidate->chainWork < index.chainWork) {
+        break;
+      }
+
+      if (candidate->height >= index.height &&
+          candidate->getAncestor(index.height) == &index) {
+        ret.push_back(candidate);
+      }
+    }
+    return ret;
+  }
+
+  //! @return all candidates, in order of iteration
+  std::vector<index_t*> getTips() const {
+    std::vector<index_t*> ret;
+    ret.reserve(tips_.size());
+    for (const auto& tip : tips_) {
+      ret.push_back(tip.second);
+    }
+    return ret;
+  }
+
+  const_iterator begin() const { return tips_.begin(); }
+  const_iterator end() const { return tips_.end(); }
+  size_t size() const { return tips_.size(); }
+  bool empty() const { return tips_.empty(); }
+
+  //! candidates are equal if they have same tips, regardless of order in
+  //! which tips were added
+  bool operator==(const ForkCandidates& o) const {
+    if (size() != o.size()) {
+      return false;
+    }
+    for (const auto& tip : sequences_) {
+      if (!o.contains(tip.first)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  tips_t tips_;
+  std::unordered_map<const index_t*, uint64_t> sequences_;
+  uint64_t nextSequence_ = 0;
+};
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_FORK_CANDIDATES_HPP_
@@ -35,20 +35,25 @@ struct Miner {
 
   // One must define their own template specialization for given Block and
   // ChainParams types. Otherwise, get pretty compilation error.
+  //! @param window window of `tip`, if known, see BlockTree::getChainWindow
   Block getBlockTemplate(const BlockIndex<Block>& tip,
-                         const merkle_t& merkleRoot);
+                         const merkle_t& merkleRoot,
+                         const ChainWindow<Block>* window = nullptr);
 
-  Block createNextBlock(const index_t& prev, const merkle_t& merkle) {
-    Block block = getBlockTemplate(prev, merkle);
+  Block createNextBlock(const index_t& prev,
+                        const merkle_t& merkle,
+                        const ChainWindow<Block>* window = nullptr) {
+    Block block = getBlockTemplate(prev, merkle, window);
     createBlock(block);
     return block;
   }
 
-  Block createNextBlock(const index_t& prev) {
+  Block createNextBlock(const index_t& prev,
+                        const ChainWindow<Block>* window = nullptr) {
     merkle_t merkle;
     std::generate(
         merkle.begin(), merkle.end(), []() { return uint8_t(rand() & 0xff); });
-    return createNextBlock(prev, merkle);
+    return createNextBlock(prev, merkle, window);
   }
 
  private:
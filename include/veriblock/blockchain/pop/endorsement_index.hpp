@@ -0,0 +1,82 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_POP_ENDORSEMENT_INDEX_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_POP_ENDORSEMENT_INDEX_HPP_
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace altintegration {
+
+/**
+ * Index of blocks of a protected tree by ids of endorsements they contain.
+ *
+ * Same endorsement can be contained in blocks on different forks, so every
+ * id maps to a (usually single element) list of containing blocks.
+ *
+ * @tparam ProtectedIndex block index type of protected tree
+ */
+template <typename ProtectedIndex>
+struct EndorsementIndex {
+  using index_t = ProtectedIndex;
+  using height_t = typename index_t::height_t;
+  using eid_t = typename index_t::eid_t;
+
+  void add(const eid_t& id, index_t* containing) {
+    auto& blocks = blocks_[id];
+    if (std::find(blocks.begin(), blocks.end(), containing) == blocks.end()) {
+      blocks.push_back(containing);
+    }
+  }
+
+  void remove(const eid_t& id, const index_t* containing) {
+    auto it = blocks_.find(id);
+    if (it == blocks_.end()) {
+      return;
+    }
+
+    auto& blocks = it->second;
+    blocks.erase(std::remove(blocks.begin(), blocks.end(), containing),
+                 blocks.end());
+    if (blocks.empty()) {
+      blocks_.erase(it);
+    }
+  }
+
+  //! @return block, which contains endorsement `id`, is an ancestor of `tip`
+  //! (or `tip` itself) and is not lower than `minHeight`, or nullptr
+  index_t* find(const eid_t& id,
+                const index_t& tip,
+                height_t minHeight) const {
+    auto it = blocks_.find(id);
+    if (it == blocks_.end()) {
+      return nullptr;
+    }
+
+    for (auto* block : it->second) {
+      if (block->height < minHeight || block->height > tip.height) {
+        continue;
+      }
+
+      if (tip.getAncestor(block->height) == block &&
+          block->getPopData().containingEndorsements.count(id)) {
+        return block;
+      }
+    }
+
+    return nullptr;
+  }
+
+  size_t size() const { return blocks_.size(); }
+
+ private:
+  std::unordered_map<eid_t, std::vector<index_t*>> blocks_;
+};
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_POP_ENDORSEMENT_INDEX_HPP_
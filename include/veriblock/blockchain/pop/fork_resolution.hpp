@@ -6,14 +6,21 @@
 #ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_POP_FORK_RESOLUTION_HPP_
 #define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_POP_FORK_RESOLUTION_HPP_
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <veriblock/blockchain/block_index.hpp>
 #include <veriblock/blockchain/blocktree.hpp>
+#include <veriblock/blockchain/pop/endorsement_index.hpp>
 #include <veriblock/blockchain/pop/pop_state_machine.hpp>
 #include <veriblock/blockchain/pop/pop_utils.hpp>
+#include <veriblock/blockchain/undo_log.hpp>
+#include <veriblock/bounded_cache.hpp>
 #include <veriblock/entities/payloads.hpp>
 #include <veriblock/finalizer.hpp>
 #include <veriblock/keystone_util.hpp>
@@ -110,6 +117,53 @@ struct KeystoneContextList {
   }
 };
 
+//! @param dependsOnTip if not nullptr, set to true if result may change when
+//! best chain of `tree` is extended
+template <typename ProtectingBlockT, typename ProtectingChainParams>
+KeystoneContext getKeystoneContextOf(
+    const ProtoKeystoneContext<ProtectingBlockT>& pkc,
+    const BlockTree<ProtectingBlockT, ProtectingChainParams>& tree,
+    bool* dependsOnTip = nullptr) {
+  int earliestEndorsementIndex = std::numeric_limits<int32_t>::max();
+  for (const auto* btcIndex : pkc.referencedByBlocks) {
+    if (btcIndex == nullptr) {
+      continue;
+    }
+
+    auto endorsementIndex = btcIndex->height;
+    if (endorsementIndex >= earliestEndorsementIndex) {
+      continue;
+    }
+
+    if (pkc.timestampOfEndorsedBlock < btcIndex->getBlockTime()) {
+      earliestEndorsementIndex = endorsementIndex;
+      continue;
+    }
+
+    // look at the future BTC blocks and set the
+    // earliestEndorsementIndex to a future Bitcoin block. Ensure that the
+    // keystone's block time isn't later than the block time of the Bitcoin
+    // block it's endorsed in
+    auto* adjusted = tree.getBestChain().findFirstBlockWithTimeAfter(
+        endorsementIndex + 1, pkc.timestampOfEndorsedBlock);
+    if (adjusted == nullptr) {
+      // adjusted index may be found in blocks, which extend best chain
+      if (dependsOnTip != nullptr) {
+        *dependsOnTip = true;
+      }
+      continue;
+    }
+
+    // Timestamp of VeriBlock block is lower than Bitcoin block, set this as
+    // the adjusted index if another lower index has not already been set
+    if (adjusted->height < earliestEndorsementIndex) {
+      earliestEndorsementIndex = adjusted->height;
+    }
+  }  // end for
+
+  return KeystoneContext{pkc.blockHeight, earliestEndorsementIndex};
+}
+
 template <typename ProtectingBlockT, typename ProtectingChainParams>
 std::vector<KeystoneContext> getKeystoneContext(
     const std::vector<ProtoKeystoneContext<ProtectingBlockT>>& chain,
@@ -117,56 +171,74 @@ std::vector<KeystoneContext> getKeystoneContext(
   std::vector<KeystoneContext> ret;
   ret.reserve(chain.size());
 
-  std::transform(
-      chain.begin(),
-      chain.end(),
-      std::back_inserter(ret),
-      [&tree](const ProtoKeystoneContext<ProtectingBlockT>& pkc) {
-        int earliestEndorsementIndex = std::numeric_limits<int32_t>::max();
-        for (const auto* btcIndex : pkc.referencedByBlocks) {
-          if (btcIndex == nullptr) {
-            continue;
-          }
+  std::transform(chain.begin(),
+                 chain.end(),
+                 std::back_inserter(ret),
+                 [&](const ProtoKeystoneContext<ProtectingBlockT>& pkc) {
+                   return getKeystoneContextOf(pkc, tree);
+                 });
 
-          auto endorsementIndex = btcIndex->height;
-          if (endorsementIndex >= earliestEndorsementIndex) {
-            continue;
-          }
+  return ret;
+}
 
-          if (pkc.timestampOfEndorsedBlock < btcIndex->getBlockTime()) {
-            earliestEndorsementIndex = endorsementIndex;
-            continue;
-          }
+//! Find all protecting blocks, which contain endorsements of a keystone at
+//! `keystoneHeight` or blocks which connect it to the previous keystone.
+//! @param isOnChain predicate, which returns true if given protected block
+//! hash is on `chain`
+//! @param dependsOnTip if not nullptr, set to true if result may change when
+//! best chain of `tree` is extended
+template <typename ProtectedBlockT,
+          typename ProtectingBlockT,
+          typename ProtectingChainParams,
+          typename OnChainPredicate>
+ProtoKeystoneContext<ProtectingBlockT> getProtoKeystoneContextOf(
+    const Chain<BlockIndex<ProtectedBlockT>>& chain,
+    int keystoneHeight,
+    int keystoneInterval,
+    const BlockTree<ProtectingBlockT, ProtectingChainParams>& tree,
+    const OnChainPredicate& isOnChain,
+    bool* dependsOnTip = nullptr) {
+  ProtoKeystoneContext<ProtectingBlockT> pkc(keystoneHeight,
+                                             chain[keystoneHeight]->height);
+
+  const auto& best = tree.getBestChain();
+  auto highestConnectingBlock =
+      highestBlockWhichConnectsKeystoneToPrevious(keystoneHeight,
+                                                  keystoneInterval);
+  for (auto relevantEndorsedBlock = keystoneHeight;
+       relevantEndorsedBlock <= highestConnectingBlock &&
+       relevantEndorsedBlock <= chain.chainHeight();
+       relevantEndorsedBlock++) {
+    auto* index = chain[relevantEndorsedBlock];
+
+    // chain must contain relevantEndorsedBlock
+    assert(index != nullptr);
+
+    for (const auto* e : index->getPopData().endorsedBy) {
+      if (!isOnChain(e->containingHash)) {
+        // do not count endorsement whose containingHash is not on the same
+        // chain as 'endorsedHash'
+        continue;
+      }
 
-          // look at the future BTC blocks and set the--0
-          // earliestEndorsementIndex to a future Bitcoin block
-          auto best = tree.getBestChain();
-          for (int adjustedEndorsementIndex = endorsementIndex + 1;
-               adjustedEndorsementIndex <= best.chainHeight();
-               adjustedEndorsementIndex++) {
-            // Ensure that the keystone's block time isn't later than the
-            // block time of the Bitcoin block it's endorsed in
-            auto* index = best[adjustedEndorsementIndex];
-            assert(index != nullptr);
-            if (pkc.timestampOfEndorsedBlock < index->getBlockTime()) {
-              // Timestamp of VeriBlock block is lower than Bitcoin block,
-              // set this as the adjusted index if another lower index has
-              // not already been set
-              if (adjustedEndorsementIndex < earliestEndorsementIndex) {
-                earliestEndorsementIndex = adjustedEndorsementIndex;
-              }
+      auto* ind = resolveBlockOfProof(*e, tree);
+      if (!best.contains(ind)) {
+        if (dependsOnTip != nullptr &&
+            (ind == nullptr || ind->height > best.chainHeight())) {
+          // block of proof may become a part of extended best chain
+          *dependsOnTip = true;
+        }
+        continue;
+      }
 
-              // Always break; we found a valid Bitcoin index and any
-              // future adjustedEndorsementIndex is going to be higher
-              break;
-            }  // end if
-          }    // end for
-        }      // end for
+      // include only endorsements that are on best chain of protecting chain,
+      // and whose 'containingHash' is on the same chain as 'endorsedHash'
+      pkc.referencedByBlocks.insert(ind);
 
-        return KeystoneContext{pkc.blockHeight, earliestEndorsementIndex};
-      });
+    }  // end for
+  }    // end for
 
-  return ret;
+  return pkc;
 }
 
 template <typename ProtectedBlockT,
@@ -177,16 +249,19 @@ std::vector<ProtoKeystoneContext<ProtectingBlockT>> getProtoKeystoneContext(
     const Chain<BlockIndex<ProtectedBlockT>>& chain,
     const BlockTree<ProtectingBlockT, ProtectingChainParams>& tree,
     const ProtectedChainParams& config) {
+  using hash_t = typename ProtectedBlockT::hash_t;
   std::vector<ProtoKeystoneContext<ProtectingBlockT>> ret;
 
   auto ki = config.getKeystoneInterval();
   auto* tip = chain.tip();
   assert(tip != nullptr && "tip must not be nullptr");
 
-  auto highestPossibleEndorsedBlockHeaderHeight = tip->height;
   auto lastKeystone = highestKeystoneAtOrBefore(tip->height, ki);
   auto firstKeystone = firstKeystoneAfter(chain.first()->height, ki);
   const auto allHashesInChain = chain.getAllHashesInChain();
+  auto isOnChain = [&allHashesInChain](const hash_t& hash) -> bool {
+    return allHashesInChain.count(hash) > 0;
+  };
 
   // For each keystone, find the endorsements of itself and other blocks which
   // reference it, and look at the earliest Bitcoin block that any of those
@@ -194,40 +269,8 @@ std::vector<ProtoKeystoneContext<ProtectingBlockT>> getProtoKeystoneContext(
   for (auto keystoneToConsider = firstKeystone;
        keystoneToConsider <= lastKeystone;
        keystoneToConsider = firstKeystoneAfter(keystoneToConsider, ki)) {
-    ProtoKeystoneContext<ProtectingBlockT> pkc(
-        keystoneToConsider, chain[keystoneToConsider]->height);
-
-    auto highestConnectingBlock =
-        highestBlockWhichConnectsKeystoneToPrevious(keystoneToConsider, ki);
-    for (auto relevantEndorsedBlock = keystoneToConsider;
-         relevantEndorsedBlock <= highestConnectingBlock &&
-         relevantEndorsedBlock <= highestPossibleEndorsedBlockHeaderHeight;
-         relevantEndorsedBlock++) {
-      auto* index = chain[relevantEndorsedBlock];
-
-      // chain must contain relevantEndorsedBlock
-      assert(index != nullptr);
-
-      for (const auto* e : index->endorsedBy) {
-        if (!allHashesInChain.count(e->containingHash)) {
-          // do not count endorsement whose containingHash is not on the same
-          // chain as 'endorsedHash'
-          continue;
-        }
-
-        auto* ind = tree.getBlockIndex(e->blockOfProof);
-        if (!tree.getBestChain().contains(ind)) {
-          continue;
-        }
-
-        // include only endorsements that are on best chain of protecting chain,
-        // and whose 'containingHash' is on the same chain as 'endorsedHash'
-        pkc.referencedByBlocks.insert(ind);
-
-      }  // end for
-    }    // end for
-
-    ret.push_back(std::move(pkc));
+    ret.push_back(getProtoKeystoneContextOf(
+        chain, keystoneToConsider, ki, tree, isOnChain));
   }  // end for
 
   return ret;
@@ -335,6 +378,9 @@ int comparePopScoreImpl(const std::vector<KeystoneContext>& chainA,
 
 }  // namespace internal
 
+//! max number of keystone contexts, which a comparator keeps
+constexpr const size_t KEYSTONE_CONTEXT_CACHE_SIZE = 1000;
+
 template <typename ProtectedBlock,
           typename ProtectedParams,
           typename ProtectingBlockTree>
@@ -346,8 +392,10 @@ struct PopAwareForkResolutionComparator {
   using protected_index_t = BlockIndex<protected_block_t>;
   using protecting_index_t = typename ProtectingBlockTree::index_t;
   using protecting_block_t = typename protecting_index_t::block_t;
+  using protecting_block_hash_t = typename protecting_block_t::hash_t;
   using context_t = typename protected_index_t::context_t;
   using endorsement_t = typename protected_block_t::endorsement_t;
+  using eid_t = typename endorsement_t::id_t;
   using protected_payloads_t = typename protected_index_t::payloads_t;
   using sm_t = PopStateMachine<ProtectingBlockTree,
                                BlockIndex<protected_block_t>,
@@ -369,12 +417,34 @@ struct PopAwareForkResolutionComparator {
       const PopAwareForkResolutionComparator& comparator) {
     this->index_ = comparator.index_;
     this->tree_ = comparator.tree_;
+    this->endorsements_ = comparator.endorsements_;
     return *this;
   }
 
   ProtectingBlockTree& getProtectingBlockTree() { return tree_; }
   const ProtectingBlockTree& getProtectingBlockTree() const { return tree_; }
   const protected_index_t* getIndex() const { return index_; }
+  const EndorsementIndex<protected_index_t>& getEndorsementIndex() const {
+    return endorsements_;
+  }
+
+  //! number of keystone contexts, which were reused from the cache or
+  //! computed by comparePopScore
+  struct KeystoneContextCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+  };
+  const KeystoneContextCacheStats& getKeystoneContextCacheStats() const {
+    return keystoneContextCacheStats_;
+  }
+
+  //! attach journal to this comparator and its protecting tree.
+  //! Pass nullptr to detach.
+  void setUndoLog(UndoLog* log) {
+    undo_.reset(log);
+    tree_.setUndoLog(log);
+  }
+  UndoLog* getUndoLog() const { return undo_.get(); }
 
   void removePayloads(protected_index_t& index,
                       const std::vector<protected_payloads_t>& payloads) {
@@ -391,10 +461,11 @@ struct PopAwareForkResolutionComparator {
     }
     // remove all endorsements and context blocks related to given payloads, in
     // reverse order (this should be faster)
+    saveContext(index);
     std::for_each(
         payloads.rbegin(), payloads.rend(), [&](const protected_payloads_t& p) {
           if (p.containsEndorsements()) {
-            removeEndorsement(index, p.getEndorsementId());
+            doRemoveEndorsement(index, p.getEndorsementId());
           }
           removeContextFromBlockIndex(index, p);
         });
@@ -404,10 +475,13 @@ struct PopAwareForkResolutionComparator {
     assert(ret);
   }
 
+  //! @invariant: atomic. On failure, every change made to this comparator,
+  //! its protecting tree and `index` is reverted.
   bool addPayloads(protected_index_t& index,
                    const std::vector<protected_payloads_t>& payloads,
                    ValidationState& state) {
-    return tryValidateWithResources(
+    return tryValidateWithUndoLog(
+        *this,
         [&]() -> bool {
           if (index_ != index.pprev) {
             // set state machine to "previous state"
@@ -420,7 +494,7 @@ struct PopAwareForkResolutionComparator {
             if (index_ == index.pprev) {
               // we added a block which does not contain payloads and it is
               // right after our current state
-              index_ = &index;
+              setIndex(&index);
               return true;
             }
           }
@@ -439,20 +513,16 @@ struct PopAwareForkResolutionComparator {
 
             // we need to add context blocks to current block index, before
             // applyContext
+            saveContext(index);
             addContextToBlockIndex(index, c, sm.tree());
 
             // first, check if context is valid.
             if (!sm.applyContext(index, state)) {
-              removeContextFromBlockIndex(index, c);
               return state.Invalid("apply-context", i);
             }
 
             if (c.containsEndorsements()) {
-              if (!checkAndAddEndorsement(index,
-                                          c.getEndorsement(),
-                                          sm.tree(),
-                                          *protectedParams_,
-                                          state)) {
+              if (!doAddEndorsement(index, c.getEndorsement(), state)) {
                 return state.Invalid("check-endorsement", i);
               }
             }
@@ -462,17 +532,16 @@ struct PopAwareForkResolutionComparator {
           assert(&index == sm.index());
 
           // update current state
-          index_ = &index;
+          setIndex(&index);
 
           return true;
-        },
-        [&] { removePayloads(index, payloads); });
+        });
   }
 
   bool setState(protected_index_t& index, ValidationState& state) {
     // if previous state is unknown, set new state as current
     if (index_ == nullptr) {
-      index_ = &index;
+      setIndex(&index);
       return true;
     }
 
@@ -481,16 +550,15 @@ struct PopAwareForkResolutionComparator {
       return true;
     }
 
-    auto temp = tree_;
-    sm_t sm(temp, index_, *protectedParams_);
-    if (!sm.unapplyAndApply(index, state)) {
-      return state.Invalid("pop-comparator-unapply-apply");
-    }
-
-    tree_ = std::move(temp);
-    index_ = sm.index();
+    return tryValidateWithUndoLog(*this, [&]() -> bool {
+      sm_t sm(tree_, index_, *protectedParams_);
+      if (!sm.unapplyAndApply(index, state)) {
+        return state.Invalid("pop-comparator-unapply-apply");
+      }
 
-    return true;
+      setIndex(sm.index());
+      return true;
+    });
   }
 
   int comparePopScore(const Chain<protected_index_t>& chainA,
@@ -505,9 +573,10 @@ struct PopAwareForkResolutionComparator {
 
     auto minHeight = std::min(index_->height, chainA.first()->height);
 
-    // make a tree copy
-    auto temp = tree_;
-    sm_t sm(temp, index_, *protectedParams_, minHeight);
+    // all changes made to the tree below are speculative, and reverted when
+    // this scope ends
+    UndoLogScope<PopAwareForkResolutionComparator> speculative(*this);
+    sm_t sm(tree_, index_, *protectedParams_, minHeight);
     // try set current state to chain A
     if (!sm.unapplyAndApply(*chainA.tip(), state)) {
       // failed - try set state to chain B
@@ -526,7 +595,7 @@ struct PopAwareForkResolutionComparator {
       return -1;
     }
 
-    // 'temp' now corresponds to chain A.
+    // 'tree_' now corresponds to chain A.
     // apply all payloads from chain B (both chains have same first block - fork
     // point at keystone)
     if (!sm.apply(*chainB.tip(), state)) {
@@ -535,30 +604,50 @@ struct PopAwareForkResolutionComparator {
       return 1;
     }
 
-    // now 'temp' contains payloads from both chains
-
-    // rename
-    const auto& gpkc = internal::getProtoKeystoneContext<protected_block_t,
-                                                         protecting_block_t,
-                                                         protecting_params_t,
-                                                         protected_params_t>;
-    const auto& gkc =
-        internal::getKeystoneContext<protecting_block_t, protecting_params_t>;
-
-    /// filter chainA
-    auto pkcChain1 = gpkc(chainA, temp, *protectedParams_);
-    auto kcChain1 = gkc(pkcChain1, temp);
+    // now 'tree_' contains payloads from both chains
 
-    /// filter chainB
-    auto pkcChain2 = gpkc(chainB, temp, *protectedParams_);
-    auto kcChain2 = gkc(pkcChain2, temp);
+    auto kcChain1 = getKeystoneContext(chainA);
+    auto kcChain2 = getKeystoneContext(chainB);
 
-    // do not update current tree, just abandon 'temp' tree
+    // do not commit changes, 'tree_' is reverted to its previous state
 
     return internal::comparePopScoreImpl<protected_params_t>(
         kcChain1, kcChain2, *protectedParams_);
   }
 
+  /**
+   * Restore comparator of a tree, which is loaded from storage. Endorsements
+   * contained in `blocks` are indexed and added to 'endorsedBy' of blocks
+   * they endorse. Protecting tree must be loaded already and correspond to
+   * `index`, which becomes the current state. Not journaled.
+   */
+  bool restore(protected_index_t& index,
+               const std::vector<protected_index_t*>& blocks,
+               ValidationState& state) {
+    for (auto* block : blocks) {
+      for (const auto& e : block->getPopData().containingEndorsements) {
+        auto* endorsed = block->getAncestor(e.second->endorsedHeight);
+        if (endorsed == nullptr ||
+            endorsed->getHash() != e.second->endorsedHash) {
+          return state.Invalid("load-no-endorsed-block",
+                               "can not find block endorsed by " +
+                                   HexStr(e.first));
+        }
+
+        endorsements_.add(e.first, block);
+        addToEndorsedBy(*endorsed, e.second.get());
+      }
+    }
+
+    index_ = &index;
+    return true;
+  }
+
+  //! remove all endorsements contained in `index`. Not journaled.
+  void removeContainingEndorsements(protected_index_t& index) {
+    removeAllContainingEndorsements(index, endorsements_);
+  }
+
   bool operator==(const PopAwareForkResolutionComparator& o) const {
     return index_ == o.index_ && tree_ == o.tree_;
   }
@@ -579,8 +668,213 @@ struct PopAwareForkResolutionComparator {
   ProtectingBlockTree tree_;
   protected_index_t* index_ = nullptr;
 
+  //! blocks containing endorsements, by endorsement id
+  EndorsementIndex<protected_index_t> endorsements_;
+
   const protected_params_t* protectedParams_;
   const protecting_params_t* protectingParams_;
+
+  UndoLogRef undo_;
+
+  //! keystone at height 'keystone' of a chain, which contains 'horizon'
+  struct KeystoneContextKey {
+    //! highest block of the compared chain, which may contain endorsements
+    //! of the keystone
+    protected_block_hash_t horizon;
+    int keystone;
+
+    bool operator==(const KeystoneContextKey& o) const {
+      return keystone == o.keystone && horizon == o.horizon;
+    }
+  };
+
+  struct KeystoneContextKeyHash {
+    size_t operator()(const KeystoneContextKey& key) const {
+      return std::hash<protected_block_hash_t>()(key.horizon) ^
+             static_cast<size_t>(internal::mixHash(uint64_t(key.keystone)));
+    }
+  };
+
+  //! keystone context, computed for a particular state of its inputs
+  struct CachedKeystoneContext {
+    //! combined 'endorsedBy' digest of blocks connecting the keystone to the
+    //! previous one
+    uint64_t endorsedByDigest;
+    //! best chain tip of protecting tree
+    protecting_block_hash_t protectingTip;
+    int protectingTipHeight;
+    //! if false, context stays valid when protecting best chain is extended
+    bool dependsOnProtectingTip;
+    internal::KeystoneContext context;
+  };
+
+  using KeystoneContextCache = BoundedCache<KeystoneContextKey,
+                                            CachedKeystoneContext,
+                                            KeystoneContextKeyHash>;
+
+  //! cached keystone contexts. Shared with copies of this comparator, since
+  //! entries are validated against their inputs before use.
+  std::shared_ptr<KeystoneContextCache> keystoneContextCache_ =
+      std::make_shared<KeystoneContextCache>(KEYSTONE_CONTEXT_CACHE_SIZE);
+  KeystoneContextCacheStats keystoneContextCacheStats_;
+
+  //! @return contexts of all keystones of `chain`, which is speculatively
+  //! applied to protecting tree. Contexts of keystones whose endorsements and
+  //! protecting best chain did not change since previous call are reused.
+  std::vector<internal::KeystoneContext> getKeystoneContext(
+      const Chain<protected_index_t>& chain) {
+    auto ki = protectedParams_->getKeystoneInterval();
+    auto window = protectedParams_->getEndorsementSettlementInterval();
+    auto* first = chain.first();
+    auto* tip = chain.tip();
+    assert(tip != nullptr && "tip must not be nullptr");
+    auto* protectingTip = tree_.getBestChain().tip();
+
+    // hashes of blocks of 'chain', collected only if some keystone context
+    // has to be computed
+    std::unordered_set<protected_block_hash_t> chainHashes;
+    auto isOnChain = [&](const protected_block_hash_t& hash) -> bool {
+      if (chainHashes.empty()) {
+        for (auto* index = tip; index != nullptr && index != first->pprev;
+             index = index->pprev) {
+          chainHashes.insert(index->getHash());
+        }
+      }
+      return chainHashes.count(hash) > 0;
+    };
+
+    std::vector<internal::KeystoneContext> ret;
+    auto lastKeystone = highestKeystoneAtOrBefore(tip->height, ki);
+    for (auto keystone = firstKeystoneAfter(first->height, ki);
+         keystone <= lastKeystone;
+         keystone = firstKeystoneAfter(keystone, ki)) {
+      if (protectingTip == nullptr) {
+        // protecting tree is not bootstrapped, nothing to cache
+        auto pkc = internal::getProtoKeystoneContextOf(
+            chain, keystone, ki, tree_, isOnChain);
+        ret.push_back(internal::getKeystoneContextOf(pkc, tree_));
+        continue;
+      }
+
+      auto highestConnectingBlock =
+          highestBlockWhichConnectsKeystoneToPrevious(keystone, ki);
+      auto highestEndorsedBlock = std::min(highestConnectingBlock, tip->height);
+
+      // endorsements can not be contained in blocks which are more than
+      // 'window' blocks after endorsed block
+      auto* horizon = chain[std::min(highestConnectingBlock + window,
+                                     tip->height)];
+      // endorsement ids are unique, so XOR of digests of blocks changes
+      // whenever an endorsement is added to or removed from any of them
+      uint64_t digest = 0;
+      for (auto height = keystone; height <= highestEndorsedBlock; height++) {
+        digest ^= chain[height]->getPopData().endorsedByDigest;
+      }
+
+      KeystoneContextKey key{horizon->getHash(), keystone};
+      CachedKeystoneContext cached{};
+      if (keystoneContextCache_->get(key, cached) &&
+          cached.endorsedByDigest == digest &&
+          isProtectingTipCompatible(cached, *protectingTip)) {
+        ++keystoneContextCacheStats_.hits;
+        ret.push_back(cached.context);
+        continue;
+      }
+
+      ++keystoneContextCacheStats_.misses;
+      bool dependsOnTip = false;
+      auto pkc = internal::getProtoKeystoneContextOf(
+          chain, keystone, ki, tree_, isOnChain, &dependsOnTip);
+      auto kc = internal::getKeystoneContextOf(pkc, tree_, &dependsOnTip);
+
+      cached.endorsedByDigest = digest;
+      cached.protectingTip = protectingTip->getHash();
+      cached.protectingTipHeight = protectingTip->height;
+      cached.dependsOnProtectingTip = dependsOnTip;
+      cached.context = kc;
+      keystoneContextCache_->insertOrAssign(key, cached);
+      ret.push_back(kc);
+    }
+
+    return ret;
+  }
+
+  //! @return true if cached context is valid for protecting best chain,
+  //! which ends at `tip`
+  static bool isProtectingTipCompatible(const CachedKeystoneContext& cached,
+                                        const protecting_index_t& tip) {
+    if (cached.protectingTip == tip.getHash()) {
+      return true;
+    }
+
+    if (cached.dependsOnProtectingTip ||
+        tip.height < cached.protectingTipHeight) {
+      return false;
+    }
+
+    // best chain has been extended
+    auto* ancestor = tip.getAncestor(cached.protectingTipHeight);
+    return ancestor != nullptr && ancestor->getHash() == cached.protectingTip;
+  }
+
+  void setIndex(protected_index_t* index) {
+    auto* old = index_;
+    undo_.record([this, old]() { index_ = old; });
+    index_ = index;
+  }
+
+  //! remember context of given block index, to restore it on rollback
+  void saveContext(protected_index_t& index) {
+    if (!undo_) {
+      return;
+    }
+
+    auto* ptr = &index;
+    context_t ctx = index.getPopData().containingContext;
+    undo_.record([ptr, ctx]() { ptr->touchPopData().containingContext = ctx; });
+  }
+
+  bool doAddEndorsement(protected_index_t& index,
+                        const endorsement_t& e,
+                        ValidationState& state) {
+    bool isNew = index.getPopData().containingEndorsements.count(e.id) == 0;
+    if (!checkAndAddEndorsement(
+            index, e, tree_, *protectedParams_, endorsements_, state)) {
+      return false;
+    }
+
+    if (isNew) {
+      auto* ptr = &index;
+      eid_t id = e.id;
+      undo_.record(
+          [this, ptr, id]() { removeEndorsement(*ptr, id, endorsements_); });
+    }
+
+    return true;
+  }
+
+  void doRemoveEndorsement(protected_index_t& index, const eid_t& id) {
+    const auto& endorsements = index.getPopData().containingEndorsements;
+    auto it = endorsements.find(id);
+    if (it == endorsements.end()) {
+      return;
+    }
+
+    if (undo_) {
+      auto* ptr = &index;
+      std::shared_ptr<endorsement_t> endorsement = it->second;
+      auto* endorsed = endorsement->endorsedIndex;
+      undo_.record([this, ptr, id, endorsement, endorsed]() {
+        ptr->touchPopData().containingEndorsements.insert({id, endorsement});
+        endorsements_.add(id, ptr);
+        if (endorsed != nullptr) {
+          addToEndorsedBy(*endorsed, endorsement.get());
+        }
+      });
+    }
+
+    removeEndorsement(index, id, endorsements_);
+  }
 };
 
 }  // namespace altintegration
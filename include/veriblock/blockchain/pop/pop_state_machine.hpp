@@ -7,14 +7,15 @@
 #define ALTINTEGRATION_POP_STATE_MACHINE_HPP
 
 #include <functional>
-#include <veriblock/blockchain/chain.hpp>
+#include <veriblock/blockchain/chain_view.hpp>
 #include <veriblock/storage/payloads_repository.hpp>
 
 namespace altintegration {
 
 /// @invariant NOT atomic - given a block tree, if any of functions fail, state
-/// is NOT changed back. It you care about the state of your tree, COPY your
-/// block tree and use copy in this state machine here.
+/// is NOT changed back. It you care about the state of your tree, attach an
+/// UndoLog to your block tree (see tryValidateWithUndoLog) and rollback on
+/// failure.
 template <typename ProtectingBlockTree,
           typename ProtectedIndex,
           typename ProtectedChainParams>
@@ -45,7 +46,7 @@ struct PopStateMachine {
       return;
     }
 
-    Chain<ProtectedIndex> chain(startHeight_, index_);
+    ChainView<ProtectedIndex> chain(startHeight_, index_);
     auto* forkPoint = chain.findFork(&to);
     auto* current = chain.tip();
     while (current && current != forkPoint) {
@@ -65,9 +66,9 @@ struct PopStateMachine {
       return true;
     }
 
-    Chain<ProtectedIndex> fork(startHeight_, &to);
+    ChainView<ProtectedIndex> fork(startHeight_, &to);
 
-    auto* current = const_cast<ProtectedIndex*>(fork.findFork(index_));
+    auto* current = fork.findFork(index_);
     assert(current);
 
     // move forward from forkPoint to "to" and apply payloads in between
@@ -7,13 +7,79 @@
 #define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_POP_POP_UTILS_HPP_
 
 #include <algorithm>
+#include <cassert>
 #include <unordered_set>
 
-#include "veriblock/blockchain/chain.hpp"
+#include "veriblock/blockchain/chain_view.hpp"
+#include "veriblock/blockchain/pop/endorsement_index.hpp"
 #include "veriblock/validation_state.hpp"
 
 namespace altintegration {
 
+//! remember `index` as block of proof of `e`
+template <typename Endorsement, typename ProtectingIndex>
+void setBlockOfProofIndex(const Endorsement& e, ProtectingIndex* index) {
+  e.blockOfProofIndex = index;
+  e.blockOfProofHeight = index == nullptr ? 0 : index->height;
+}
+
+//! @return index of block of proof of `e` in `tree`, or nullptr if it is
+//! unknown. Index, remembered in `e`, is reused without hash lookup if it is
+//! still on the best chain of `tree`.
+template <typename ProtectingBlockTree, typename Endorsement>
+typename ProtectingBlockTree::index_t* resolveBlockOfProof(
+    const Endorsement& e, const ProtectingBlockTree& tree) {
+  // remembered index may belong to another tree, so it is compared with best
+  // chain blocks before it is dereferenced
+  auto* index = e.blockOfProofIndex;
+  if (index != nullptr &&
+      tree.getBestChain()[e.blockOfProofHeight] == index &&
+      index->getHash() == e.blockOfProof) {
+    return index;
+  }
+
+  index = tree.getBlockIndex(e.blockOfProof);
+  setBlockOfProofIndex(e, index);
+  return index;
+}
+
+//! append `endorsement` to 'endorsedBy' list of `endorsed` block
+template <typename ProtectedIndex>
+void addToEndorsedBy(ProtectedIndex& endorsed,
+                     typename ProtectedIndex::endorsement_t* endorsement) {
+  assert(endorsement->endorsedIndex == nullptr);
+  auto& endorsedPop = endorsed.touchPopData();
+  endorsement->endorsedIndex = &endorsed;
+  endorsement->endorsedByPosition = endorsedPop.endorsedBy.size();
+  endorsedPop.endorsedBy.push_back(endorsement);
+  endorsedPop.toggleEndorsedBy(*endorsement);
+}
+
+//! remove `endorsement` from 'endorsedBy' list of the block it endorses.
+//! Order of remaining endorsements is not preserved.
+template <typename Endorsement>
+void removeFromEndorsedBy(const Endorsement* endorsement) {
+  auto* endorsed = endorsement->endorsedIndex;
+  if (endorsed == nullptr) {
+    return;
+  }
+
+  auto& endorsedPop = endorsed->touchPopData();
+  auto& endorsements = endorsedPop.endorsedBy;
+  auto position = endorsement->endorsedByPosition;
+  assert(position < endorsements.size() &&
+         endorsements[position] == endorsement);
+
+  // move last endorsement to the freed slot
+  auto* last = endorsements.back();
+  endorsements[position] = last;
+  last->endorsedByPosition = position;
+  endorsements.pop_back();
+
+  endorsement->endorsedIndex = nullptr;
+  endorsedPop.toggleEndorsedBy(*endorsement);
+}
+
 template <typename ProtectingBlockTree,
           typename ProtectedIndex,
           typename ProtectedChainParams>
@@ -22,12 +88,13 @@ bool checkAndAddEndorsement(
     const typename ProtectedIndex::endorsement_t& endorsement,
     const ProtectingBlockTree& tree,
     const ProtectedChainParams& params,
+    EndorsementIndex<ProtectedIndex>& endorsements,
     ValidationState& state) {
   using endorsement_t = typename ProtectedIndex::endorsement_t;
   // endorsement validity window
   auto window = params.getEndorsementSettlementInterval();
   auto minHeight = index.height >= window ? index.height - window : 0;
-  Chain<ProtectedIndex> chain(minHeight, &index);
+  ChainView<ProtectedIndex> chain(minHeight, &index);
 
   auto endorsedHeight = endorsement.endorsedHeight;
   if (index.height - endorsedHeight > window) {
@@ -52,7 +119,9 @@ bool checkAndAddEndorsement(
   }
 
   if (endorsement_t::checkForDuplicates) {
-    auto* duplicate = chain.findBlockContainingEndorsement(endorsement, window);
+    // duplicate may be contained in any block after endorsed block
+    auto* duplicate =
+        endorsements.find(endorsement.id, index, endorsedHeight + 1);
     if (duplicate) {
       // found duplicate
       return state.Invalid("duplicate",
@@ -61,11 +130,13 @@ bool checkAndAddEndorsement(
   }
 
   // Add endorsement into BlockIndex
-  auto pair = index.containingEndorsements.insert(
+  auto pair = index.touchPopData().containingEndorsements.insert(
       {endorsement.id, std::make_shared<endorsement_t>(endorsement)});
   if (pair.second) {
+    endorsements.add(endorsement.id, &index);
     auto* eptr = pair.first->second.get();
-    endorsed->endorsedBy.push_back(eptr);
+    setBlockOfProofIndex(*eptr, blockOfProof);
+    addToEndorsedBy(*endorsed, eptr);
   }
 
   return true;
@@ -74,47 +145,39 @@ bool checkAndAddEndorsement(
 template <typename ProtectedIndex>
 void removeEndorsement(
     ProtectedIndex& index,
-    const typename ProtectedIndex::endorsement_t::id_t& eid) {
-  auto endorsementit = index.containingEndorsements.find(eid);
-  if (endorsementit == index.containingEndorsements.end()) {
+    const typename ProtectedIndex::endorsement_t::id_t& eid,
+    EndorsementIndex<ProtectedIndex>& endorsementIndex) {
+  if (!index.hasPopData()) {
+    return;
+  }
+
+  auto& endorsements = index.touchPopData().containingEndorsements;
+  auto endorsementit = endorsements.find(eid);
+  if (endorsementit == endorsements.end()) {
     return;
   }
 
   auto& endorsement_ptr = endorsementit->second;
 
   // remove from 'endorsedBy'
-  removeFromEndorsedBy(index, endorsement_ptr.get());
+  removeFromEndorsedBy(endorsement_ptr.get());
+  endorsementIndex.remove(eid, &index);
   // remove from 'containing endorsements'
-  index.containingEndorsements.erase(endorsementit);
+  endorsements.erase(endorsementit);
 }
 
 template <typename ProtectedIndex>
-void removeAllContainingEndorsements(ProtectedIndex& index) {
-  for (auto it = index.containingEndorsements.begin();
-       it != index.containingEndorsements.end();) {
-    removeFromEndorsedBy(index, it->second.get());
-    it = index.containingEndorsements.erase(it);
+void removeAllContainingEndorsements(
+    ProtectedIndex& index, EndorsementIndex<ProtectedIndex>& endorsementIndex) {
+  if (!index.hasPopData()) {
+    return;
   }
-}
-
-template <typename ProtectedIndex>
-void removeFromEndorsedBy(
-    ProtectedIndex& index,
-    const typename ProtectedIndex::endorsement_t* endorsement) {
-  using endorsement_t = typename ProtectedIndex::endorsement_t;
 
-  auto endorsed = index.getAncestor(endorsement->endorsedHeight);
-  if (endorsed) {
-    auto& endorsements = const_cast<ProtectedIndex*>(endorsed)->endorsedBy;
-    auto new_end = std::remove_if(endorsements.begin(),
-                                  endorsements.end(),
-                                  [&endorsement](endorsement_t* e) -> bool {
-                                    // remove nullptrs and our given
-                                    // endorsement
-                                    return !e || endorsement == e;
-                                  });
-
-    endorsements.erase(new_end, endorsements.end());
+  auto& endorsements = index.touchPopData().containingEndorsements;
+  for (auto it = endorsements.begin(); it != endorsements.end();) {
+    removeFromEndorsedBy(it->second.get());
+    endorsementIndex.remove(it->first, &index);
+    it = endorsements.erase(it);
   }
 }
 
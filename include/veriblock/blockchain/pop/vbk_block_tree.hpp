@@ -57,6 +57,14 @@ struct VbkBlockTree : public BlockTree<VbkBlock, VbkChainParams> {
 
   void invalidateBlockByHash(const hash_t& blockHash) override;
 
+  //! BTC tree must be loaded first. It has to correspond to the stored VBK
+  //! tip, which becomes the state of the comparator.
+  bool loadBlocks(const std::vector<index_t>& blocks,
+                  const hash_t* tip,
+                  ValidationState& state) override;
+
+  void setUndoLog(UndoLog* log) override;
+
   bool addPayloads(const block_t& block,
                    const std::vector<payloads_t>& payloads,
                    ValidationState& state,
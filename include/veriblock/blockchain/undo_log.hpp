@@ -0,0 +1,154 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_UNDO_LOG_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_UNDO_LOG_HPP_
+
+#include <functional>
+#include <utility>
+#include <vector>
+#include <veriblock/finalizer.hpp>
+
+namespace altintegration {
+
+/**
+ * Journal of reversible mutations.
+ *
+ * Every mutation of a block tree (or comparator) which is attached to the log
+ * records a closure that restores the previous state. Rollback executes
+ * closures in reverse order, so the cost of reverting is proportional to the
+ * number of changes, not to the size of the tree.
+ */
+struct UndoLog {
+  using action_t = std::function<void()>;
+
+  //! number of recorded actions. Can be used as a mark for rollback.
+  size_t size() const { return actions_.size(); }
+
+  void record(action_t undo) {
+    if (reverting_) {
+      // mutations done during rollback are not journaled
+      return;
+    }
+    actions_.push_back(std::move(undo));
+  }
+
+  //! revert all mutations recorded after given mark
+  void rollback(size_t mark = 0) {
+    reverting_ = true;
+    Finalizer done([this]() { reverting_ = false; });
+    while (actions_.size() > mark) {
+      auto undo = std::move(actions_.back());
+      actions_.pop_back();
+      undo();
+    }
+  }
+
+  //! forget recorded mutations, making them permanent
+  void clear() { actions_.clear(); }
+
+ private:
+  std::vector<action_t> actions_;
+  bool reverting_ = false;
+};
+
+/**
+ * Non-owning reference to an attached UndoLog.
+ *
+ * A copy of a journaled object never inherits the log of the original, and
+ * assignment does not change the log of the target.
+ */
+struct UndoLogRef {
+  UndoLogRef() = default;
+  UndoLogRef(const UndoLogRef&) {}
+  UndoLogRef& operator=(const UndoLogRef&) { return *this; }
+
+  UndoLog* get() const { return log_; }
+  void reset(UndoLog* log = nullptr) { log_ = log; }
+
+  explicit operator bool() const { return log_ != nullptr; }
+
+  //! record undo action, if log is attached
+  template <typename F>
+  void record(F&& undo) const {
+    if (log_ != nullptr) {
+      log_->record(std::forward<F>(undo));
+    }
+  }
+
+ private:
+  UndoLog* log_ = nullptr;
+};
+
+/**
+ * Scoped attachment of an UndoLog to a journaled object.
+ *
+ * Unless committed, all changes made to `journaled` during lifetime of the
+ * scope are reverted on scope exit. If `journaled` is already attached to a
+ * log, then the outer log is reused and only changes made within this scope
+ * are reverted.
+ *
+ * @tparam Journaled type with `getUndoLog()` and `setUndoLog(UndoLog*)`
+ */
+template <typename Journaled>
+struct UndoLogScope {
+  explicit UndoLogScope(Journaled& journaled)
+      : journaled_(journaled),
+        outer_(journaled.getUndoLog()),
+        log_(outer_ != nullptr ? outer_ : &local_),
+        mark_(log_->size()) {
+    if (outer_ == nullptr) {
+      journaled_.setUndoLog(&local_);
+    }
+  }
+
+  UndoLogScope(const UndoLogScope&) = delete;
+  UndoLogScope& operator=(const UndoLogScope&) = delete;
+
+  ~UndoLogScope() {
+    Finalizer detach([this]() {
+      if (outer_ == nullptr) {
+        journaled_.setUndoLog(nullptr);
+      }
+    });
+
+    if (!committed_) {
+      log_->rollback(mark_);
+    }
+  }
+
+  //! keep changes made within this scope
+  void commit() { committed_ = true; }
+
+ private:
+  Journaled& journaled_;
+  UndoLog local_;
+  UndoLog* outer_;
+  UndoLog* log_;
+  size_t mark_;
+  bool committed_ = false;
+};
+
+/**
+ * Execute validation function with `journaled` attached to an UndoLog.
+ * If action returns false or throws, all changes done by it are reverted.
+ *
+ * @tparam Journaled type with `getUndoLog()` and `setUndoLog(UndoLog*)`
+ */
+template <typename Journaled>
+bool tryValidateWithUndoLog(Journaled& journaled,
+                            const std::function<bool()>& action) {
+  UndoLogScope<Journaled> scope(journaled);
+  if (!action()) {
+    return false;
+  }
+
+  scope.commit();
+  return true;
+}
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BLOCKCHAIN_UNDO_LOG_HPP_
@@ -17,23 +17,36 @@ namespace altintegration {
 template <>
 uint32_t getNextWorkRequired(const BlockIndex<VbkBlock>& currentTip,
                              const VbkBlock& block,
-                             const VbkChainParams& params);
+                             const VbkChainParams& params,
+                             const ChainWindow<VbkBlock>* window);
+
+template <>
+void buildRetargetWindow(const BlockIndex<VbkBlock>& index,
+                         const ChainWindow<VbkBlock>* prev,
+                         const VbkChainParams& params,
+                         ChainWindow<VbkBlock>& window);
 
 template <>
 VbkBlock Miner<VbkBlock, VbkChainParams>::getBlockTemplate(
-    const BlockIndex<VbkBlock>& tip, const merkle_t& merkle);
+    const BlockIndex<VbkBlock>& tip,
+    const merkle_t& merkle,
+    const ChainWindow<VbkBlock>* window);
 
 template <>
 ArithUint256 getBlockProof(const VbkBlock& block);
 
-int64_t getMedianTimePast(const BlockIndex<VbkBlock>& prev);
+int64_t getMedianTimePast(const BlockIndex<VbkBlock>& prev,
+                          const ChainWindow<VbkBlock>* window = nullptr);
 
 template <>
 bool checkBlockTime(const BlockIndex<VbkBlock>& prev,
                     const VbkBlock& block,
-                    ValidationState& state);
+                    ValidationState& state,
+                    const ChainWindow<VbkBlock>* window);
 
-int64_t calculateMinimumTimestamp(const BlockIndex<VbkBlock>& prev);
+int64_t calculateMinimumTimestamp(
+    const BlockIndex<VbkBlock>& prev,
+    const ChainWindow<VbkBlock>* window = nullptr);
 
 bool validateKeystones(const BlockIndex<VbkBlock>& prevBlock,
                        const VbkBlock& block,
@@ -43,7 +56,8 @@ template <>
 bool contextuallyCheckBlock(const BlockIndex<VbkBlock>& prev,
                             const VbkBlock& block,
                             ValidationState& state,
-                            const VbkChainParams& params);
+                            const VbkChainParams& params,
+                            const ChainWindow<VbkBlock>* window);
 
 }  // namespace altintegration
 
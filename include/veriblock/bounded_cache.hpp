@@ -0,0 +1,149 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_BOUNDED_CACHE_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_BOUNDED_CACHE_HPP_
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace altintegration {
+
+namespace internal {
+
+//! entries of `Container`, which is either a set or a map of keys, and
+//! order of their insertion, used to evict the oldest entry
+template <typename Key, typename Container>
+class BoundedFifo {
+ public:
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reset();
+  }
+
+  //! change max number of stored entries. Clears the cache.
+  void setMaxSize(size_t maxSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reset();
+    maxSize_ = maxSize;
+  }
+
+ protected:
+  explicit BoundedFifo(size_t maxSize) : maxSize_(maxSize) {}
+
+  //! insert an entry with `args` unless `key` is present. Must be called
+  //! with the mutex locked.
+  template <typename... Args>
+  void emplace(const Key& key, Args&&... args) {
+    if (maxSize_ == 0 || !items_.emplace(std::forward<Args>(args)...).second) {
+      return;
+    }
+
+    if (order_.size() < maxSize_) {
+      order_.push_back(key);
+      return;
+    }
+
+    // full: replace the oldest entry, order_ is used as a ring buffer
+    items_.erase(order_[next_]);
+    order_[next_] = key;
+    next_ = (next_ + 1) % maxSize_;
+  }
+
+  mutable std::mutex mutex_;
+  Container items_;
+
+ private:
+  std::vector<Key> order_;
+  size_t next_ = 0;
+  size_t maxSize_;
+
+  void reset() {
+    items_.clear();
+    order_.clear();
+    next_ = 0;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Bounded map of keys to values.
+ *
+ * Safe to use from multiple threads. When the cache is full, the oldest entry
+ * is evicted. Values of present keys are replaced by insertOrAssign only.
+ */
+template <typename Key, typename Value = void, typename Hash = std::hash<Key>>
+class BoundedCache
+    : public internal::BoundedFifo<Key,
+                                   std::unordered_map<Key, Value, Hash>> {
+  using base =
+      internal::BoundedFifo<Key, std::unordered_map<Key, Value, Hash>>;
+
+ public:
+  explicit BoundedCache(size_t maxSize) : base(maxSize) {}
+
+  //! @return true and write value of `key` to `out`, if it is cached
+  bool get(const Key& key, Value& out) const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto it = this->items_.find(key);
+    if (it == this->items_.end()) {
+      return false;
+    }
+
+    out = it->second;
+    return true;
+  }
+
+  void insert(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->emplace(key, key, value);
+  }
+
+  //! same as insert, but replaces value of present `key`. Replaced entry
+  //! keeps its place in eviction order.
+  void insertOrAssign(const Key& key, const Value& value) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto it = this->items_.find(key);
+    if (it != this->items_.end()) {
+      it->second = value;
+      return;
+    }
+
+    this->emplace(key, key, value);
+  }
+};
+
+//! bounded set of keys, see BoundedCache
+template <typename Key, typename Hash>
+class BoundedCache<Key, void, Hash>
+    : public internal::BoundedFifo<Key, std::unordered_set<Key, Hash>> {
+  using base = internal::BoundedFifo<Key, std::unordered_set<Key, Hash>>;
+
+ public:
+  explicit BoundedCache(size_t maxSize) : base(maxSize) {}
+
+  bool contains(const Key& key) const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    return this->items_.count(key) > 0;
+  }
+
+  void insert(const Key& key) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->emplace(key, key);
+  }
+};
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_BOUNDED_CACHE_HPP_
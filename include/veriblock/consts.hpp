@@ -24,6 +24,7 @@ constexpr const int BTC_MAX_FUTURE_BLOCK_TIME = 2 * 60 * 60;
 constexpr const int VBK_MAX_FUTURE_BLOCK_TIME = 5 * 60;
 
 constexpr const auto HISTORY_FOR_TIMESTAMP_AVERAGE = 20;
+constexpr const auto BTC_MEDIAN_TIME_SPAN = 11;
 
 constexpr const auto VBK_MINIMUM_TIMESTAMP_ONSET_BLOCK_HEIGHT = 110000;
 constexpr const auto ALT_KEYSTONE_INTERVAL = 5;
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "veriblock/blob.hpp"
 #include "veriblock/entities/context.hpp"
 #include "veriblock/entities/endorsements.hpp"
 #include "veriblock/serde.hpp"
@@ -59,6 +60,19 @@ struct AltBlock {
    */
   std::vector<uint8_t> toVbkEncoding() const;
 
+  /**
+   * Read AltBlock stored with toRaw
+   * @param stream data stream to read from
+   * @return AltBlock
+   */
+  static AltBlock fromRaw(ReadStream& stream);
+
+  /**
+   * Convert AltBlock to data stream for storage. Same as Vbk byte format.
+   * @param stream data stream to write into
+   */
+  void toRaw(WriteStream& stream) const;
+
   hash_t getHash() const { return hash; }
 
   friend bool operator==(const AltBlock& a, const AltBlock& b) {
@@ -81,7 +95,7 @@ namespace std {
 template <>
 struct hash<std::vector<uint8_t>> {
   size_t operator()(const std::vector<uint8_t>& x) const {
-    return std::hash<std::string>{}(std::string{x.begin(), x.end()});
+    return altintegration::internal::saltedHash(x.data(), x.size());
   }
 };
 
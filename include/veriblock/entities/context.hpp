@@ -24,6 +24,19 @@ struct VbkContext {
       btc_context{};
 
   bool empty() const noexcept { return btc_context.empty(); }
+
+  /**
+   * Convert VbkContext to data stream for storage
+   * @param stream data stream to write into
+   */
+  void toRaw(WriteStream& stream) const;
+
+  /**
+   * Read VbkContext written with toRaw
+   * @param stream data stream to read from
+   * @return VbkContext
+   */
+  static VbkContext fromRaw(ReadStream& stream);
 };
 
 struct PartialVTB {
@@ -61,6 +74,19 @@ struct PartialVTB {
 
   static std::vector<PartialVTB> fromVTB(const std::vector<VTB>& vtbs);
 
+  /**
+   * Convert PartialVTB to data stream for storage
+   * @param stream data stream to write into
+   */
+  void toRaw(WriteStream& stream) const;
+
+  /**
+   * Read PartialVTB written with toRaw
+   * @param stream data stream to read from
+   * @return PartialVTB
+   */
+  static PartialVTB fromRaw(ReadStream& stream);
+
   friend bool operator==(const PartialVTB& a, const PartialVTB& b);
 };
 
@@ -71,6 +97,19 @@ struct AltContext {
   std::vector<PartialVTB> vtbs{};
 
   bool empty() const noexcept { return vbk.empty() && vtbs.empty(); }
+
+  /**
+   * Convert AltContext to data stream for storage
+   * @param stream data stream to write into
+   */
+  void toRaw(WriteStream& stream) const;
+
+  /**
+   * Read AltContext written with toRaw
+   * @param stream data stream to read from
+   * @return AltContext
+   */
+  static AltContext fromRaw(ReadStream& stream);
 };
 
 }  // namespace altintegration
@@ -11,6 +11,9 @@
 
 namespace altintegration {
 
+template <typename Block>
+struct BlockIndex;
+
 //  Protecting Chain:
 //    A - B - C - D - E - F - G - H - I - J
 //                       /
@@ -28,10 +31,16 @@ namespace altintegration {
 template <class EndorsedHash,
           class ContainingHash,
           class Container,
-          class EndorsedBlockHeight>
+          class EndorsedBlockHeight,
+          class EndorsedBlock,
+          class ProtectingBlock>
 struct Endorsement {
-  using type =
-      Endorsement<EndorsedHash, ContainingHash, Container, EndorsedBlockHeight>;
+  using type = Endorsement<EndorsedHash,
+                           ContainingHash,
+                           Container,
+                           EndorsedBlockHeight,
+                           EndorsedBlock,
+                           ProtectingBlock>;
   using id_t = uint256;
   using endorsed_hash_t = EndorsedHash;
   using containing_hash_t = ContainingHash;
@@ -46,6 +55,18 @@ struct Endorsement {
   ContainingHash blockOfProof;
   std::vector<uint8_t> payoutInfo;
 
+  //! index of 'blockOfProof' in protecting tree, remembered by the last
+  //! lookup. Not a part of the endorsement, may be stale. See
+  //! resolveBlockOfProof.
+  mutable BlockIndex<ProtectingBlock>* blockOfProofIndex = nullptr;
+  mutable int32_t blockOfProofHeight = 0;
+
+  //! endorsed block, whose 'endorsedBy' list contains this endorsement, and
+  //! position in that list. Maintained by addToEndorsedBy and
+  //! removeFromEndorsedBy.
+  mutable BlockIndex<EndorsedBlock>* endorsedIndex = nullptr;
+  mutable size_t endorsedByPosition = 0;
+
   static Endorsement fromVbkEncoding(std::string) {
     // TODO: remove
     return {};
@@ -56,6 +77,29 @@ struct Endorsement {
     return {};
   }
 
+  //! write endorsement to the stream for storage, see BlockIndex::toRaw.
+  //! Remembered indices are not written.
+  void toRaw(WriteStream& stream) const {
+    writeSingleByteLenValue(stream, id);
+    writeVarLenValue(stream, endorsedHash);
+    stream.writeBE<EndorsedBlockHeight>(endorsedHeight);
+    writeVarLenValue(stream, containingHash);
+    writeVarLenValue(stream, blockOfProof);
+    writeVarLenValue(stream, payoutInfo);
+  }
+
+  //! read endorsement, written with toRaw
+  static type fromRaw(ReadStream& stream) {
+    type e;
+    e.id = readSingleByteLenValue(stream, id_t::size(), id_t::size());
+    e.endorsedHash = readVarLenValue(stream).asVector();
+    e.endorsedHeight = stream.readBE<EndorsedBlockHeight>();
+    e.containingHash = readVarLenValue(stream).asVector();
+    e.blockOfProof = readVarLenValue(stream).asVector();
+    e.payoutInfo = readVarLenValue(stream).asVector();
+    return e;
+  }
+
   // TODO(Bogdan): temporary used to disable duplicate check
   static bool checkForDuplicates;
 
@@ -13,9 +13,13 @@ namespace altintegration {
 struct VTB;
 struct AltPayloads;
 struct PartialVTB;
+struct AltBlock;
+struct BtcBlock;
+struct VbkBlock;
 
 // endorsement of VBK blocks in BTC
-using BtcEndorsement = Endorsement<uint192, uint256, VTB, int32_t>;
+using BtcEndorsement =
+    Endorsement<uint192, uint256, VTB, int32_t, VbkBlock, BtcBlock>;
 
 template <>
 BtcEndorsement BtcEndorsement ::fromContainer(const VTB& c);
@@ -23,8 +27,12 @@ template <>
 BtcEndorsement::id_t BtcEndorsement::getId(const VTB& c);
 
 // endorsement of ALT blocks in VBK
-using VbkEndorsement =
-    Endorsement<std::vector<uint8_t>, uint192, AltPayloads, int32_t>;
+using VbkEndorsement = Endorsement<std::vector<uint8_t>,
+                                   uint192,
+                                   AltPayloads,
+                                   int32_t,
+                                   AltBlock,
+                                   VbkBlock>;
 template <>
 VbkEndorsement VbkEndorsement ::fromContainer(const AltPayloads& c);
 template <>
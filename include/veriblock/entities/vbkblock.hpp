@@ -101,7 +101,18 @@ struct VbkBlock {
   uint32_t getBlockTime() const;
 
   friend bool operator==(const VbkBlock& a, const VbkBlock& b) {
-    return a.getHash() == b.getHash();
+    // compare serialized fields instead of calculating two hashes
+    // clang-format off
+    return a.height == b.height &&
+           a.version == b.version &&
+           a.previousBlock == b.previousBlock &&
+           a.previousKeystone == b.previousKeystone &&
+           a.secondPreviousKeystone == b.secondPreviousKeystone &&
+           a.merkleRoot == b.merkleRoot &&
+           a.timestamp == b.timestamp &&
+           a.difficulty == b.difficulty &&
+           a.nonce == b.nonce;
+    // clang-format on
   }
 
   friend bool operator!=(const VbkBlock& a, const VbkBlock& b) {
@@ -10,37 +10,169 @@
 #include <memory>
 #include <vector>
 
+#include "veriblock/blockchain/alt_block_tree.hpp"
 #include "veriblock/blockchain/blocktree.hpp"
+#include "veriblock/blockchain/pop/vbk_block_tree.hpp"
 #include "veriblock/state_manager.hpp"
 #include "veriblock/validation_state.hpp"
 
 namespace altintegration {
 
+namespace internal {
+
+//! block, which is stored as a tip of the tree: tip of the active chain
 template <typename Block_t, typename ChainParams_t>
-bool loadBlockTree(
-    BlockTree<Block_t, ChainParams_t>& tree,
-    std::shared_ptr<typename BlockRepository<BlockIndex<Block_t>>::cursor_t>
-        cursor,
-    ValidationState& state) {
-  std::vector<BlockIndex<Block_t>> blocks;
+const BlockIndex<Block_t>* getSavedTip(
+    const BlockTree<Block_t, ChainParams_t>& tree) {
+  return tree.getBestChain().tip();
+}
+
+//! block, which is stored as a tip of the tree: block, which POP state of the
+//! tree is set to
+inline const BlockIndex<AltBlock>* getSavedTip(const AltTree& tree) {
+  return tree.getState();
+}
+
+template <typename Tree>
+void putSavedTip(const Tree& tree,
+                 BlockWriteBatch<BlockIndex<typename Tree::block_t>>& batch) {
+  auto* tip = getSavedTip(tree);
+  if (tip != nullptr) {
+    batch.putTip(tip->getHash());
+  }
+}
+
+}  // namespace internal
 
+/**
+ * Restore block tree from the repository, without replaying blocks.
+ *
+ * Tree must be empty. Headers, heights, statuses and POP data of blocks are
+ * restored, as well as the stored tip. For POP-protected trees, protecting
+ * trees have to be loaded first, see loadTrees.
+ */
+template <typename Tree>
+bool loadBlockTree(Tree& tree,
+                   BlockRepository<BlockIndex<typename Tree::block_t>>& repo,
+                   ValidationState& state) {
+  using index_t = BlockIndex<typename Tree::block_t>;
+  std::vector<index_t> blocks;
+
+  auto cursor = repo.newCursor();
   for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
     blocks.push_back(cursor->value());
   }
 
   std::sort(blocks.begin(),
             blocks.end(),
-            [](const BlockIndex<Block_t>& block1,
-               const BlockIndex<Block_t>& block2) -> bool {
+            [](const index_t& block1, const index_t& block2) -> bool {
               return block1.height < block2.height;
             });
 
-  for (const auto& block : blocks) {
-    if (!tree.acceptBlock(block.header, state)) {
-      return state.addStackFunction("loadBlockTree()");
-    }
+  typename Tree::hash_t tip;
+  bool hasTip = repo.getTip(&tip);
+  if (!tree.loadBlocks(blocks, hasTip ? &tip : nullptr, state)) {
+    return state.Invalid("load-block-tree");
+  }
+
+  return true;
+}
+
+/**
+ * Write all blocks of the tree, both valid and failed, and its tip to the
+ * repository in a single batch. Blocks, which are already stored, are
+ * overwritten, so that their status is up to date.
+ */
+template <typename Tree>
+void saveBlockTree(Tree& tree,
+                   BlockRepository<BlockIndex<typename Tree::block_t>>& repo) {
+  auto batch = repo.newBatch();
+  for (const auto& block : tree.getValidBlocks()) {
+    batch->put(*block.second);
+  }
+  for (const auto& block : tree.getFailedBlocks()) {
+    batch->put(*block.second);
+  }
+  internal::putSavedTip(tree, *batch);
+  batch->commit();
+  tree.clearChangedBlocks();
+}
+
+/**
+ * Write blocks, which were added or changed since the tree was loaded or
+ * saved, and the tip of the tree to the repository in a single batch.
+ *
+ * Should be called when the tree is in a stable state, i.e. not during
+ * validation of a block.
+ */
+template <typename Tree>
+void saveBlockTreeChanges(
+    Tree& tree, BlockRepository<BlockIndex<typename Tree::block_t>>& repo) {
+  auto batch = repo.newBatch();
+  for (const auto* block : tree.getChangedBlocks()) {
+    batch->put(*block);
+  }
+  internal::putSavedTip(tree, *batch);
+  batch->commit();
+  tree.clearChangedBlocks();
+}
+
+/**
+ * Restore VBK tree together with BTC tree, which it contains.
+ */
+inline bool loadTrees(VbkBlockTree& vbk,
+                      BlockRepository<BlockIndex<BtcBlock>>& btcRepo,
+                      BlockRepository<BlockIndex<VbkBlock>>& vbkRepo,
+                      ValidationState& state) {
+  return loadBlockTree(vbk.btc(), btcRepo, state) &&
+         loadBlockTree(vbk, vbkRepo, state);
+}
+
+/**
+ * Save changes of VBK tree and BTC tree, which it contains.
+ *
+ * BTC tree is switched to the state of the VBK tip first, so that stored trees
+ * correspond to each other.
+ */
+inline bool saveTrees(VbkBlockTree& vbk,
+                      BlockRepository<BlockIndex<BtcBlock>>& btcRepo,
+                      BlockRepository<BlockIndex<VbkBlock>>& vbkRepo,
+                      ValidationState& state) {
+  auto* tip = vbk.getBestChain().tip();
+  if (tip != nullptr && !vbk.getComparator().setState(*tip, state)) {
+    return state.Invalid("save-vbk-state");
+  }
+
+  saveBlockTreeChanges(vbk.btc(), btcRepo);
+  saveBlockTreeChanges(vbk, vbkRepo);
+  return true;
+}
+
+/**
+ * Restore ALT tree together with VBK and BTC trees, which it contains.
+ */
+inline bool loadTrees(AltTree& alt,
+                      BlockRepository<BlockIndex<BtcBlock>>& btcRepo,
+                      BlockRepository<BlockIndex<VbkBlock>>& vbkRepo,
+                      BlockRepository<BlockIndex<AltBlock>>& altRepo,
+                      ValidationState& state) {
+  return loadTrees(alt.vbk(), btcRepo, vbkRepo, state) &&
+         loadBlockTree(alt, altRepo, state);
+}
+
+/**
+ * Save changes of ALT tree and VBK and BTC trees, which it contains.
+ */
+inline bool saveTrees(AltTree& alt,
+                      BlockRepository<BlockIndex<BtcBlock>>& btcRepo,
+                      BlockRepository<BlockIndex<VbkBlock>>& vbkRepo,
+                      BlockRepository<BlockIndex<AltBlock>>& altRepo,
+                      ValidationState& state) {
+  if (!saveTrees(alt.vbk(), btcRepo, vbkRepo, state)) {
+    return false;
   }
 
+  saveBlockTreeChanges(alt, altRepo);
   return true;
 }
 
@@ -17,6 +17,7 @@
 #include "veriblock/entities/vtb.hpp"
 #include "veriblock/signutil.hpp"
 #include "veriblock/time.hpp"
+#include "veriblock/validation_cache.hpp"
 
 namespace altintegration {
 
@@ -43,6 +44,13 @@ bool checkMerklePath(const MerklePathType& merklePath,
   return true;
 }
 
+/**
+ * Process-wide cache of successfully verified signatures, shared by all
+ * checkSignature overloads. Payloads which were accepted once (e.g. to the
+ * mempool) are not verified again when they are delivered in a block.
+ */
+ValidationCache& getSignatureCache();
+
 bool checkSignature(const VbkTx& tx, ValidationState& state);
 
 bool checkSignature(const VbkPopTx& tx, ValidationState& state);
@@ -74,6 +74,12 @@ struct BlockWriteBatch {
    */
   virtual void removeByHash(const hash_t& hash) = 0;
 
+  /**
+   * Write hash of the tip of stored block tree. Overwrites previous tip.
+   * @param hash tip hash
+   */
+  virtual void putTip(const hash_t& hash) = 0;
+
   /**
    * Clear batch from any modifying operations.
    */
@@ -145,6 +151,19 @@ struct BlockRepository {
    */
   virtual bool removeByHash(const hash_t& hash) = 0;
 
+  /**
+   * Write hash of the tip of stored block tree. Overwrites previous tip.
+   * @param hash tip hash
+   */
+  virtual void putTip(const hash_t& hash) = 0;
+
+  /**
+   * Load hash of the tip of stored block tree.
+   * @param out[out] tip hash
+   * @return true if tip found, false otherwise.
+   */
+  virtual bool getTip(hash_t* out) const = 0;
+
   /**
    * Clear the entire blocks data.
    */
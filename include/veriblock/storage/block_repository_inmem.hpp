@@ -25,7 +25,7 @@ struct BlockCursorInmem : public Cursor<typename Block::hash_t, Block> {
   using pair = std::pair<hash_t, std::shared_ptr<stored_block_t>>;
 
   BlockCursorInmem(const umap& map) {
-    for (const pair& m : map) {
+    for (const auto& m : map) {
       _etl.push_back(m);
     }
   }
@@ -93,7 +93,7 @@ struct BlockWriteBatchInmem : public BlockWriteBatch<Block> {
   //! block height type
   using height_t = typename Block::height_t;
 
-  enum class Operation { PUT, REMOVE_BY_HASH };
+  enum class Operation { PUT, REMOVE_BY_HASH, PUT_TIP };
 
   BlockWriteBatchInmem(BlockRepositoryInmem<stored_block_t>* repo)
       : _repo(repo) {}
@@ -108,15 +108,22 @@ struct BlockWriteBatchInmem : public BlockWriteBatch<Block> {
     _removes.push_back(hash);
   };
 
+  void putTip(const hash_t& hash) override {
+    _ops.push_back(Operation::PUT_TIP);
+    _tips.push_back(hash);
+  };
+
   void clear() override {
     _ops.clear();
     _removes.clear();
     _puts.clear();
+    _tips.clear();
   };
 
   void commit() override {
     auto puts_begin = this->_puts.begin();
     auto removes_begin = this->_removes.begin();
+    auto tips_begin = this->_tips.begin();
     for (const auto& op : this->_ops) {
       switch (op) {
         case BlockWriteBatchInmem<Block>::Operation::PUT: {
@@ -127,6 +134,10 @@ struct BlockWriteBatchInmem : public BlockWriteBatch<Block> {
           _repo->removeByHash(*removes_begin++);
           break;
         }
+        case BlockWriteBatchInmem<Block>::Operation::PUT_TIP: {
+          _repo->putTip(*tips_begin++);
+          break;
+        }
         default:
           throw std::logic_error(
               "unknown enum value - this should never happen");
@@ -139,6 +150,7 @@ struct BlockWriteBatchInmem : public BlockWriteBatch<Block> {
   BlockRepositoryInmem<stored_block_t>* _repo;
   std::vector<stored_block_t> _puts;
   std::vector<hash_t> _removes;
+  std::vector<hash_t> _tips;
   std::vector<Operation> _ops;
 };
 
@@ -192,7 +204,24 @@ struct BlockRepositoryInmem : public BlockRepository<Block> {
     return _hash.erase(hash) == 1;
   }
 
-  void clear() override { _hash.clear(); }
+  void putTip(const hash_t& hash) override {
+    _tip = hash;
+    _hasTip = true;
+  }
+
+  bool getTip(hash_t* out) const override {
+    if (!_hasTip) {
+      return false;
+    }
+
+    *out = _tip;
+    return true;
+  }
+
+  void clear() override {
+    _hash.clear();
+    _hasTip = false;
+  }
 
   std::unique_ptr<BlockWriteBatch<stored_block_t>> newBatch() override {
     return std::unique_ptr<BlockWriteBatchInmem<stored_block_t>>(
@@ -205,6 +234,8 @@ struct BlockRepositoryInmem : public BlockRepository<Block> {
 
  private:
   std::unordered_map<hash_t, std::shared_ptr<stored_block_t>> _hash;
+  hash_t _tip{};
+  bool _hasTip = false;
 };
 
 }  // namespace altintegration
@@ -9,6 +9,7 @@
 #include <rocksdb/db.h>
 
 #include <set>
+#include <string>
 
 #include "veriblock/blob.hpp"
 #include "veriblock/serde.hpp"
@@ -22,6 +23,12 @@ namespace altintegration {
 //! column family type
 using cf_handle_t = rocksdb::ColumnFamilyHandle;
 
+//! key of the tip of blocks, stored in column family `cfName`. Tips are
+//! stored in the default column family, so that block cursors do not see them.
+inline std::string makeTipKey(const std::string& cfName) {
+  return "tip_" + cfName;
+}
+
 template <typename Block>
 struct BlockCursorRocks : public Cursor<typename Block::hash_t, Block> {
   //! stored block type
@@ -51,7 +58,7 @@ struct BlockCursorRocks : public Cursor<typename Block::hash_t, Block> {
       throw std::out_of_range("invalid cursor");
     }
     auto key = _iterator->key();
-    return hash_t(key.ToString());
+    return hash_t(std::vector<uint8_t>(key.data(), key.data() + key.size()));
   }
 
   stored_block_t value() const override {
@@ -100,6 +107,15 @@ struct BlockWriteBatchRocks : public BlockWriteBatch<Block> {
     }
   }
 
+  void putTip(const hash_t& hash) override {
+    rocksdb::Status s = _batch.Put(_db->DefaultColumnFamily(),
+                                   makeTipKey(_hashBlockHandle->GetName()),
+                                   makeRocksSlice(hash));
+    if (!s.ok()) {
+      throw db::DbError(s.ToString());
+    }
+  }
+
   void clear() override { _batch.Clear(); }
 
   void commit() override {
@@ -203,6 +219,33 @@ class BlockRepositoryRocks : public BlockRepository<Block> {
     return true;
   }
 
+  void putTip(const hash_t& hash) override {
+    rocksdb::WriteOptions write_options;
+    write_options.disableWAL = true;
+    rocksdb::Status s = _db->Put(write_options,
+                                 _db->DefaultColumnFamily(),
+                                 makeTipKey(_hashBlockHandle->GetName()),
+                                 makeRocksSlice(hash));
+    if (!s.ok()) {
+      throw db::DbError(s.ToString());
+    }
+  }
+
+  bool getTip(hash_t* out) const override {
+    std::string dbValue{};
+    rocksdb::Status s = _db->Get(rocksdb::ReadOptions(),
+                                 _db->DefaultColumnFamily(),
+                                 makeTipKey(_hashBlockHandle->GetName()),
+                                 &dbValue);
+    if (!s.ok()) {
+      if (s.IsNotFound()) return false;
+      throw db::DbError(s.ToString());
+    }
+
+    *out = std::vector<uint8_t>(dbValue.begin(), dbValue.end());
+    return true;
+  }
+
   void clear() override {
     // call BlockRepositoryRocksManager.clear() instead
     return;
@@ -25,7 +25,8 @@ enum class CF_NAMES {
   HASH_BTC_ENDORSEMENT_ID,
   HASH_VBK_ENDORSEMENT_ID,
   ALT_PAYLOADS_ID,
-  VBK_PAYLOADS_ID
+  VBK_PAYLOADS_ID,
+  HASH_BLOCK_ALT
 };
 
 // column families in the DB
@@ -35,7 +36,8 @@ static const std::vector<std::string> cfNames{"default",
                                               "hash_btc_endorsement_id",
                                               "hash_vbk_endorsement_id",
                                               "alt_payloads_id",
-                                              "vbk_payloads_id"};
+                                              "vbk_payloads_id",
+                                              "hash_block_alt"};
 
 struct RepositoryRocksManager {
   template <typename Block_t>
@@ -99,6 +101,9 @@ struct RepositoryRocksManager {
     repoVbkPayloads = std::make_shared<payloads_repo_t<VTB>>(
         dbPtr, cfHandles[(int)CF_NAMES::VBK_PAYLOADS_ID]);
 
+    repoAlt = std::make_shared<block_repo_t<AltBlock>>(
+        dbPtr, cfHandles[(int)CF_NAMES::HASH_BLOCK_ALT]);
+
     return s;
   }
 
@@ -112,12 +117,18 @@ struct RepositoryRocksManager {
 
     rocksdb::Status s = rocksdb::Status::OK();
     for (size_t i = (size_t)CF_NAMES::HASH_BLOCK_BTC;
-         i <= (size_t)CF_NAMES::VBK_PAYLOADS_ID;
+         i <= (size_t)CF_NAMES::HASH_BLOCK_ALT;
          i++) {
       auto columnName = cfHandles[i]->GetName();
       s = dbPtr->DropColumnFamily(cfHandles[i].get());
       if (!s.ok()) return s;
 
+      // tips of block trees are kept in the default column family
+      s = dbPtr->Delete(rocksdb::WriteOptions(),
+                        dbPtr->DefaultColumnFamily(),
+                        makeTipKey(columnName));
+      if (!s.ok() && !s.IsNotFound()) return s;
+
       rocksdb::ColumnFamilyOptions cfOption{};
       cf_handle_t *handle = nullptr;
       s = dbPtr->CreateColumnFamily(cfOption, columnName, &handle);
@@ -144,6 +155,9 @@ struct RepositoryRocksManager {
 
     repoVbkPayloads = std::make_shared<payloads_repo_t<VTB>>(
         dbPtr, cfHandles[(int)CF_NAMES::VBK_PAYLOADS_ID]);
+
+    repoAlt = std::make_shared<block_repo_t<AltBlock>>(
+        dbPtr, cfHandles[(int)CF_NAMES::HASH_BLOCK_ALT]);
     return s;
   }
 
@@ -160,6 +174,8 @@ struct RepositoryRocksManager {
 
   std::shared_ptr<block_repo_t<VbkBlock>> getVbkRepo() const { return repoVbk; }
 
+  std::shared_ptr<block_repo_t<AltBlock>> getAltRepo() const { return repoAlt; }
+
   std::shared_ptr<endorsement_repo_t<BtcEndorsement>> getBtcEndorsementRepo()
       const {
     return repoBtcEndorsement;
@@ -191,6 +207,7 @@ struct RepositoryRocksManager {
   std::shared_ptr<endorsement_repo_t<VbkEndorsement>> repoVbkEndorsement;
   std::shared_ptr<payloads_repo_t<AltPayloads>> repoAltPayloads;
   std::shared_ptr<payloads_repo_t<VTB>> repoVbkPayloads;
+  std::shared_ptr<block_repo_t<AltBlock>> repoAlt;
 };
 
 }  // namespace altintegration
@@ -0,0 +1,27 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ALT_INTEGRATION_INCLUDE_VERIBLOCK_VALIDATION_CACHE_HPP_
+#define ALT_INTEGRATION_INCLUDE_VERIBLOCK_VALIDATION_CACHE_HPP_
+
+#include "veriblock/bounded_cache.hpp"
+#include "veriblock/uint.hpp"
+
+namespace altintegration {
+
+//! bounded set of keys of checks, which have already succeeded
+class ValidationCache : public BoundedCache<uint256> {
+ public:
+  using key_t = uint256;
+
+  static const size_t DEFAULT_MAX_SIZE = 100000;
+
+  explicit ValidationCache(size_t maxSize = DEFAULT_MAX_SIZE)
+      : BoundedCache(maxSize) {}
+};
+
+}  // namespace altintegration
+
+#endif  // ALT_INTEGRATION_INCLUDE_VERIBLOCK_VALIDATION_CACHE_HPP_
@@ -15,6 +15,28 @@ typedef struct {
   uint64_t h[8];  ///< chained state
 } vblake_ctx;
 
+/**
+ * Implementations of the compression function. By default, the fastest one
+ * supported by the CPU is used.
+ */
+typedef enum {
+  VBLAKE_IMPL_SCALAR = 0,  ///< portable reference implementation
+  VBLAKE_IMPL_SSE2 = 1,    ///< x86-64 only
+  VBLAKE_IMPL_AVX2 = 2,    ///< x86-64 CPUs with AVX2 only
+} vblake_impl;
+
+/**
+ * Select implementation of the compression function.
+ * @param impl implementation to use.
+ * @return 0 if succeeded, -1 if `impl` is not supported on this CPU.
+ */
+int vblake_set_impl(vblake_impl impl);
+
+/**
+ * @return implementation of the compression function, which is in use.
+ */
+vblake_impl vblake_get_impl(void);
+
 /**
  * Initialize the hashing context.
  * @param ctx context to initialize.
@@ -56,12 +56,129 @@ ArithUint256 ArithUint256::fromString(const std::string& num) {
   return tmp;
 }
 
+namespace {
+
+//! returns low 64 bits of `a * b + add + carry`, high 64 bits go to `hi`
+inline uint64_t mulAdd(uint64_t a,
+                       uint64_t b,
+                       uint64_t add,
+                       uint64_t carry,
+                       uint64_t& hi) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 n = (unsigned __int128)a * b + add + carry;
+  hi = (uint64_t)(n >> 64);
+  return (uint64_t)n;
+#else
+  const uint64_t mask = 0xffffffffu;
+  uint64_t ll = (a & mask) * (b & mask);
+  uint64_t lh = (a & mask) * (b >> 32);
+  uint64_t hl = (a >> 32) * (b & mask);
+  uint64_t hh = (a >> 32) * (b >> 32);
+  uint64_t mid = (ll >> 32) + (lh & mask) + (hl & mask);
+  uint64_t lo = (ll & mask) | (mid << 32);
+  uint64_t h = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  lo += add;
+  h += lo < add;
+  lo += carry;
+  h += lo < carry;
+  hi = h;
+  return lo;
+#endif
+}
+
+//! number of significant bits in `x`
+inline unsigned int bitLength(uint64_t x) {
+#if defined(__GNUC__)
+  return x == 0 ? 0 : 64 - __builtin_clzll(x);
+#else
+  unsigned int n = 0;
+  for (; x != 0; x >>= 1) {
+    ++n;
+  }
+  return n;
+#endif
+}
+
+//! number of 32-bit digits used in division
+constexpr int DIGITS = SHA256_HASH_SIZE / 4;
+
+/**
+ * Knuth's long division (TAOCP vol. 2, 4.3.1, algorithm D) over 32-bit digits.
+ * `u` has `m` significant digits, `v` has `n` significant digits, `m >= n`
+ * and `n >= 2`. Quotient digits are written to `q`.
+ */
+void divideKnuth(uint32_t* q,
+                 const uint32_t* u,
+                 const uint32_t* v,
+                 int m,
+                 int n) {
+  const uint64_t base = 1ull << 32;
+  // normalize, so that the top digit of the divisor has its high bit set
+  const unsigned int s = 32 - bitLength(v[n - 1]);
+  uint32_t vn[DIGITS];
+  uint32_t un[DIGITS + 1];
+  for (int i = n - 1; i > 0; i--) {
+    vn[i] = (uint32_t)(((uint64_t)v[i] << s) |
+                       ((uint64_t)v[i - 1] >> (32 - s)));
+  }
+  vn[0] = (uint32_t)((uint64_t)v[0] << s);
+  un[m] = (uint32_t)((uint64_t)u[m - 1] >> (32 - s));
+  for (int i = m - 1; i > 0; i--) {
+    un[i] = (uint32_t)(((uint64_t)u[i] << s) |
+                       ((uint64_t)u[i - 1] >> (32 - s)));
+  }
+  un[0] = (uint32_t)((uint64_t)u[0] << s);
+
+  for (int j = m - n; j >= 0; j--) {
+    // estimate quotient digit, it is either exact or 1 too large
+    const uint64_t num = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+    uint64_t qhat = num / vn[n - 1];
+    uint64_t rhat = num % vn[n - 1];
+    while (qhat >= base ||
+           qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+      --qhat;
+      rhat += vn[n - 1];
+      if (rhat >= base) {
+        break;
+      }
+    }
+
+    // multiply and subtract
+    uint64_t borrow = 0;
+    for (int i = 0; i < n; i++) {
+      const uint64_t p = qhat * vn[i];
+      const uint64_t t = (uint64_t)un[i + j] - borrow - (p & 0xffffffffu);
+      un[i + j] = (uint32_t)t;
+      borrow = (p >> 32) - (uint64_t)((int64_t)t >> 32);
+    }
+    const int64_t t = (int64_t)un[j + n] - (int64_t)borrow;
+    un[j + n] = (uint32_t)t;
+
+    q[j] = (uint32_t)qhat;
+    if (t < 0) {
+      // subtracted too much, add back
+      --q[j];
+      uint64_t carry = 0;
+      for (int i = 0; i < n; i++) {
+        const uint64_t n2 = (uint64_t)un[i + j] + vn[i] + carry;
+        un[i + j] = (uint32_t)n2;
+        carry = n2 >> 32;
+      }
+      un[j + n] = (uint32_t)(un[j + n] + carry);
+    }
+  }
+}
+
+}  // namespace
+
 int ArithUint256::compareTo(const ArithUint256& b) const {
-  for (int i = SHA256_HASH_SIZE - 1; i >= 0; i--) {
-    if (data_[i] < b.data_[i]) {
+  const auto a = limbs();
+  const auto c = b.limbs();
+  for (int i = WIDTH - 1; i >= 0; i--) {
+    if (a[i] < c[i]) {
       return -1;
     }
-    if (data_[i] > b.data_[i]) {
+    if (a[i] > c[i]) {
       return 1;
     }
   }
@@ -69,101 +186,110 @@ int ArithUint256::compareTo(const ArithUint256& b) const {
 }
 
 ArithUint256& ArithUint256::operator<<=(unsigned int shift) {
-  ArithUint256 a(*this);
-  for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-    data_[i] = 0;
-  }
-  int k = shift / 8;
-  shift = shift % 8;
-  for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-    if (i + k + 1 < SHA256_HASH_SIZE && shift != 0) {
-      data_[i + k + 1] |= (a.data_[i] >> (8 - shift));
-    }
-    if (i + k < SHA256_HASH_SIZE) {
-      data_[i + k] |= (a.data_[i] << shift);
+  const auto a = limbs();
+  limbs_t r{};
+  const int k = shift / 64;
+  shift = shift % 64;
+  for (int i = 0; i + k < WIDTH; i++) {
+    r[i + k] |= a[i] << shift;
+    if (i + k + 1 < WIDTH && shift != 0) {
+      r[i + k + 1] |= a[i] >> (64 - shift);
     }
   }
+  setLimbs(r);
   return *this;
 }
 
 ArithUint256& ArithUint256::operator>>=(unsigned int shift) {
-  ArithUint256 a(*this);
-  for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-    data_[i] = 0;
-  }
-  int k = shift / 8;
-  shift = shift % 8;
-  for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-    if (i - k - 1 >= 0 && shift != 0) {
-      data_[i - k - 1] |= (a.data_[i] << (8 - shift));
-    }
-    if (i - k >= 0) {
-      data_[i - k] |= (a.data_[i] >> shift);
+  const auto a = limbs();
+  limbs_t r{};
+  const int k = shift / 64;
+  shift = shift % 64;
+  for (int i = k; i < WIDTH; i++) {
+    r[i - k] |= a[i] >> shift;
+    if (i - k >= 1 && shift != 0) {
+      r[i - k - 1] |= a[i] << (64 - shift);
     }
   }
+  setLimbs(r);
   return *this;
 }
 
 ArithUint256& ArithUint256::operator*=(uint32_t b32) {
+  auto a = limbs();
   uint64_t carry = 0;
-  for (int i = 0; i < SHA256_HASH_SIZE; i++) {
-    uint64_t n = carry + (uint64_t)b32 * data_[i];
-    data_[i] = n & 0xff;
-    carry = n >> 8;
+  for (int i = 0; i < WIDTH; i++) {
+    a[i] = mulAdd(a[i], b32, 0, carry, carry);
   }
+  setLimbs(a);
   return *this;
 }
 
 ArithUint256& ArithUint256::operator*=(const ArithUint256& b) {
-  ArithUint256 a;
-  for (int j = 0; j < SHA256_HASH_SIZE; j++) {
+  const auto a = limbs();
+  const auto c = b.limbs();
+  limbs_t r{};
+  for (int j = 0; j < WIDTH; j++) {
     uint64_t carry = 0;
-    for (int i = 0; i + j < SHA256_HASH_SIZE; i++) {
-      uint64_t n = carry + a.data_[i + j] + (uint64_t)data_[j] * b.data_[i];
-      a.data_[i + j] = n & 0xff;
-      carry = n >> 8;
+    for (int i = 0; i + j < WIDTH; i++) {
+      r[i + j] = mulAdd(a[j], c[i], r[i + j], carry, carry);
     }
   }
-  *this = a;
+  setLimbs(r);
   return *this;
 }
 
 ArithUint256& ArithUint256::operator/=(const ArithUint256& b) {
-  ArithUint256 div = b;      // make a copy, so we can shift.
-  ArithUint256 num = *this;  // make a copy, so we can subtract.
-  *this = 0;                 // the quotient.
-  int num_bits = num.bits();
-  int div_bits = div.bits();
-  if (div_bits == 0) {
-    throw uint_error("Division by zero");
+  const auto a = limbs();
+  const auto c = b.limbs();
+  uint32_t u[DIGITS];
+  uint32_t v[DIGITS];
+  for (int i = 0; i < WIDTH; i++) {
+    u[2 * i] = (uint32_t)a[i];
+    u[2 * i + 1] = (uint32_t)(a[i] >> 32);
+    v[2 * i] = (uint32_t)c[i];
+    v[2 * i + 1] = (uint32_t)(c[i] >> 32);
   }
-  // the result is certainly 0.
-  if (div_bits > num_bits) {
-    return *this;
+  int m = DIGITS;
+  while (m > 0 && u[m - 1] == 0) {
+    --m;
   }
-  int shift = num_bits - div_bits;
-  div <<= shift;  // shift so that div and num align.
-  while (shift >= 0) {
-    if (num >= div) {
-      num -= div;
-      data_[shift / 8] |= (1 << (shift & 7));  // set a bit of the result.
+  int n = DIGITS;
+  while (n > 0 && v[n - 1] == 0) {
+    --n;
+  }
+  if (n == 0) {
+    throw uint_error("Division by zero");
+  }
+
+  uint32_t q[DIGITS] = {};
+  if (m < n) {
+    // the result is certainly 0.
+  } else if (n == 1) {
+    // short division by a single digit
+    uint64_t rem = 0;
+    for (int j = m - 1; j >= 0; j--) {
+      const uint64_t num = (rem << 32) | u[j];
+      q[j] = (uint32_t)(num / v[0]);
+      rem = num % v[0];
     }
-    div >>= 1;  // shift back.
-    shift--;
+  } else {
+    divideKnuth(q, u, v, m, n);
+  }
+
+  limbs_t r;
+  for (int i = 0; i < WIDTH; i++) {
+    r[i] = (uint64_t)q[2 * i] | ((uint64_t)q[2 * i + 1] << 32);
   }
-  // num now contains the remainder of the division.
+  setLimbs(r);
   return *this;
 }
 
 unsigned int ArithUint256::bits() const {
-  for (int pos = SHA256_HASH_SIZE - 1; pos >= 0; pos--) {
-    if (data_[pos]) {
-      for (int nbits = 7; nbits > 0; nbits--) {
-        if (data_[pos] & 1U << nbits) {
-          return 8 * pos + nbits + 1;
-        }
-      }
-      return 8 * pos + 1;
+  const auto a = limbs();
+  for (int pos = WIDTH - 1; pos >= 0; pos--) {
+    if (a[pos] != 0) {
+      return 64 * pos + bitLength(a[pos]);
     }
   }
   return 0;
@@ -192,11 +318,8 @@ uint32_t ArithUint256::toBits(bool negative) const {
   return nCompact;
 }
 
-uint64_t ArithUint256::getLow64() const {
-  const uint32_t* p1 = (uint32_t*)(&data_[0]);
-  const uint32_t* p2 = (uint32_t*)(&data_[4]);
-  return *p1 | (uint64_t)*p2 << 32;
-}
+uint64_t ArithUint256::getLow64() const { return limbs()[0]; }
+
 ArithUint256 ArithUint256::fromHex(const std::string& hex) {
   ArithUint256 u;
   u.setHex(hex);
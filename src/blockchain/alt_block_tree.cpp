@@ -7,6 +7,7 @@
 
 #include <unordered_set>
 
+#include "veriblock/blockchain/chain_view.hpp"
 #include "veriblock/blockchain/pop/pop_utils.hpp"
 #include "veriblock/rewards/poprewards.hpp"
 #include "veriblock/rewards/poprewards_calculator.hpp"
@@ -17,24 +18,25 @@ namespace altintegration {
 AltTree::index_t* AltTree::getBlockIndexFailed(
     const std::vector<uint8_t>& hash) const {
   auto it = failed_blocks.find(hash);
-  return it == failed_blocks.end() ? nullptr : it->second.get();
+  return it == failed_blocks.end() ? nullptr : it->second;
 }
 
 AltTree::index_t* AltTree::getBlockIndex(
     const std::vector<uint8_t>& hash) const {
   auto it = valid_blocks.find(hash);
-  return it == valid_blocks.end() ? nullptr : it->second.get();
+  return it == valid_blocks.end() ? nullptr : it->second;
 }
 
 AltTree::index_t* AltTree::touchBlockIndex(const hash_t& blockHash) {
   auto it = valid_blocks.find(blockHash);
   if (it != valid_blocks.end()) {
-    return it->second.get();
+    return it->second;
   }
 
-  auto newIndex = std::make_shared<index_t>();
-  it = valid_blocks.insert({blockHash, std::move(newIndex)}).first;
-  return it->second.get();
+  auto* newIndex = arena_->create();
+  valid_blocks.insert({blockHash, newIndex});
+  changed_.insert(newIndex);
+  return newIndex;
 }
 
 AltTree::index_t* AltTree::insertBlockHeader(const AltBlock& block) {
@@ -46,7 +48,7 @@ AltTree::index_t* AltTree::insertBlockHeader(const AltBlock& block) {
   }
 
   current = touchBlockIndex(hash);
-  current->header = std::make_shared<AltBlock>(block);
+  current->setHeader(std::make_shared<AltBlock>(block), hash);
   current->pprev = getBlockIndex(block.previousBlock);
 
   if (current->pprev != nullptr) {
@@ -58,6 +60,7 @@ AltTree::index_t* AltTree::insertBlockHeader(const AltBlock& block) {
     current->chainWork = 0;
   }
 
+  current->buildSkip();
   current->raiseValidity(BLOCK_VALID_TREE);
 
   return current;
@@ -87,6 +90,68 @@ bool AltTree::bootstrap(ValidationState& state) {
   return true;
 }
 
+bool AltTree::loadBlocks(const std::vector<index_t>& blocks,
+                         const hash_t* tip,
+                         ValidationState& state) {
+  assert(valid_blocks.empty() && "already bootstrapped");
+  if (blocks.empty()) {
+    return state.Invalid("load-empty", "no blocks to load");
+  }
+
+  if (tip == nullptr) {
+    return state.Invalid("load-no-tip", "POP state of the tree is not stored");
+  }
+
+  std::vector<index_t*> loaded;
+  loaded.reserve(blocks.size());
+  for (size_t i = 0, size = blocks.size(); i < size; i++) {
+    const auto& stored = blocks[i];
+    auto* index = insertBlockHeader(*stored.header);
+    if (i == 0) {
+      index->height = stored.height;
+    } else if (index->pprev == nullptr) {
+      return state.Invalid(
+          "load-bad-prev-block",
+          "can not find previous block for " + HexStr(stored.getHash()));
+    }
+
+    index->status = stored.status;
+    index->setStoredPopData(stored);
+    loaded.push_back(index);
+  }
+
+  // loaded blocks are stored already
+  changed_.clear();
+
+  // blocks are sorted by height, so every valid leaf becomes a chain tip
+  for (auto* index : loaded) {
+    if (index->pprev != nullptr && !index->pprev->isValid() &&
+        (index->status & BLOCK_FAILED_CHILD) == 0) {
+      index->setFlag(BLOCK_FAILED_CHILD);
+      changed_.insert(index);
+    }
+
+    if (!index->isValid()) {
+      doInvalidateBlock(index->getHash());
+      continue;
+    }
+
+    addToChains(index);
+  }
+
+  auto* current = getBlockIndex(*tip);
+  if (current == nullptr) {
+    return state.Invalid("load-bad-tip",
+                         "tip " + HexStr(*tip) + " is not a valid block");
+  }
+
+  if (!cmp_.restore(*current, loaded, state)) {
+    return state.Invalid("alt-restore-comparator");
+  }
+
+  return true;
+}
+
 bool AltTree::acceptBlock(const AltBlock& block, ValidationState& state) {
   if (getBlockIndex(block.getHash()) != nullptr) {
     // duplicate
@@ -139,11 +204,11 @@ void AltTree::invalidateBlockByIndex(index_t& blockIndex) {
   assert(ret);
 
   addToChains(blockIndex.pprev);
-  removeAllContainingEndorsements(blockIndex);
+  cmp_.removeContainingEndorsements(blockIndex);
 
   for (auto it = chainTips_.begin(); it != chainTips_.end();) {
     auto* index = *it;
-    Chain<BlockIndex<AltBlock>> chain(blockIndex.height, index);
+    ChainView<index_t> chain(blockIndex.height, index);
     if (chain.empty() || !chain.contains(&blockIndex)) {
       // this chain does not contain deleted block
       ++it;
@@ -165,8 +230,9 @@ void AltTree::invalidateBlockByIndex(index_t& blockIndex) {
 
       // mark this block as 'invalid child', because this block is after deleted
       // block
-      removeAllContainingEndorsements(*c);
+      cmp_.removeContainingEndorsements(*c);
       c->setFlag(BLOCK_FAILED_CHILD);
+      changed_.insert(c);
       doInvalidateBlock(c->getHash());
     }
 
@@ -176,6 +242,7 @@ void AltTree::invalidateBlockByIndex(index_t& blockIndex) {
 
   // mark removed block as invalid
   blockIndex.setFlag(BLOCK_FAILED_BLOCK);
+  changed_.insert(&blockIndex);
   doInvalidateBlock(blockIndex.getHash());
 }
 
@@ -187,15 +254,10 @@ bool AltTree::addPayloads(const AltBlock& containingBlock,
     return addPayloads(cmp_, containingBlock, payloads, state);
   }
 
-  // do a temp copy of comparator
-  auto copy = cmp_;
-  bool ret = addPayloads(copy, containingBlock, payloads, state);
-  if (ret) {
-    // if payloads valid, update local copy
-    cmp_ = copy;
-  }
-
-  return ret;
+  // journal all changes, and revert them if payloads are invalid
+  return tryValidateWithUndoLog(cmp_, [&]() {
+    return addPayloads(cmp_, containingBlock, payloads, state);
+  });
 }
 
 void AltTree::removePayloads(const AltBlock& containingBlock,
@@ -203,6 +265,7 @@ void AltTree::removePayloads(const AltBlock& containingBlock,
   auto* index = getBlockIndex(containingBlock.getHash());
   if (index != nullptr) {
     cmp_.removePayloads(*index, payloads);
+    changed_.insert(index);
   }
 }
 
@@ -253,8 +316,8 @@ int AltTree::compareTwoBranches(AltTree::index_t* chain1,
 
   // determine which chain is better
   auto lowestHeight = alt_config_->getBootstrapBlock().height;
-  Chain<index_t> chainA(lowestHeight, chain1);
-  Chain<index_t> chainB(lowestHeight, chain2);
+  ChainView<index_t> chainA(lowestHeight, chain1);
+  ChainView<index_t> chainB(lowestHeight, chain2);
 
   if (chainA.contains(chain2) || chainB.contains(chain1)) {
     // We compare 2 blocks from the same chain.
@@ -304,6 +367,7 @@ bool AltTree::addPayloads(AltTree::PopForkComparator& cmp,
   if (!cmp.addPayloads(*index, payloads, state)) {
     return state.Invalid("bad-alt-payloads-stateful");
   }
+  changed_.insert(index);
 
   return true;
 }
@@ -323,18 +387,15 @@ bool AltTree::PopForkComparator::sm_t::applyContext(
     const BlockIndex<AltBlock>& index, ValidationState& state) {
   return tryValidateWithResources(
       [&]() -> bool {
-        const auto& ctx = index.containingContext;
-        // apply context first
-        size_t i = 0;
-        for (const auto& b : ctx.vbk) {
-          if (!tree().acceptBlock(b, state)) {
-            return state.Invalid("alt-accept-block", i);
-          }
-          i++;
+        const auto& ctx = index.getPopData().containingContext;
+        // apply context first. It is applied on every fork comparison, so do
+        // not spawn threads
+        if (!tree().acceptBlocks(ctx.vbk, state, false)) {
+          return state.Invalid("alt-accept-block");
         }
 
         // apply all VTBs
-        i = 0;
+        size_t i = 0;
         for (const auto& vtb : ctx.vtbs) {
           if (!tree().addPayloads(*vtb.containing, {vtb}, state, false)) {
             return state.Invalid("alt-accept-block", i);
@@ -353,7 +414,7 @@ void AltTree::PopForkComparator::sm_t::unapplyContext(
   // unapply in "forward" order, because result should be same, but doing this
   // way it should be faster due to less number of calls "determineBestChain"
 
-  const auto& ctx = index.containingContext;
+  const auto& ctx = index.getPopData().containingContext;
 
   // process VBK context first
   for (const auto& b : ctx.vbk) {
@@ -375,7 +436,7 @@ template <>
 void addContextToBlockIndex(BlockIndex<AltBlock>& index,
                             const typename BlockIndex<AltBlock>::payloads_t& p,
                             const VbkBlockTree& tree) {
-  auto& ctx = index.containingContext;
+  auto& ctx = index.touchPopData().containingContext;
 
   std::unordered_set<VbkBlock::hash_t> known_vbk_blocks;
   for (const auto& b : ctx.vbk) {
@@ -417,7 +478,8 @@ void addContextToBlockIndex(BlockIndex<AltBlock>& index,
 template <>
 void removeContextFromBlockIndex(BlockIndex<AltBlock>& index,
                                  const BlockIndex<AltBlock>::payloads_t& p) {
-  auto& vbk = index.containingContext.vbk;
+  auto& ctx = index.touchPopData().containingContext;
+  auto& vbk = ctx.vbk;
   auto vbk_end = vbk.end();
   auto removeBlock = [&](const VbkBlock& b) {
     vbk_end = std::remove_if(
@@ -426,7 +488,7 @@ void removeContextFromBlockIndex(BlockIndex<AltBlock>& index,
         });
   };
 
-  auto& vtbs = index.containingContext.vtbs;
+  auto& vtbs = ctx.vtbs;
   auto vtbs_end = vtbs.end();
   auto removeVTB = [&](const VTB& vtb) {
     removeBlock(vtb.containingBlock);
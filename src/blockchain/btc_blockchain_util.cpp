@@ -30,13 +30,15 @@ ArithUint256 getBlockProof(const BtcBlock& block) {
 
 template <>
 BtcBlock Miner<BtcBlock, BtcChainParams>::getBlockTemplate(
-    const BlockIndex<BtcBlock>& tip, const merkle_t& merkle) {
+    const BlockIndex<BtcBlock>& tip,
+    const merkle_t& merkle,
+    const ChainWindow<BtcBlock>* window) {
   BtcBlock block;
   block.version = tip.header->version;
   block.previousBlock = tip.header->getHash();
   block.merkleRoot = merkle;
   block.timestamp = std::max(tip.getBlockTime(), currentTimestamp4());
-  block.bits = getNextWorkRequired(tip, block, params_);
+  block.bits = getNextWorkRequired(tip, block, params_, window);
   return block;
 }
 
@@ -73,11 +75,25 @@ static uint32_t calculateNextWorkRequired(
   return bnNew.toBits();
 }
 
+//! @return difficulty of the last block, which is not mined under special
+//! min difficulty rule
+static uint32_t getLastNonMinDifficulty(const BlockIndex<BtcBlock>& prevBlock,
+                                        const BtcChainParams& params) {
+  unsigned int nProofOfWorkLimit = ArithUint256(params.getPowLimit()).toBits();
+  const BlockIndex<BtcBlock>* pindex = &prevBlock;
+  while (pindex->pprev &&
+         pindex->height % params.getDifficultyAdjustmentInterval() != 0 &&
+         pindex->getDifficulty() == nProofOfWorkLimit)
+    pindex = pindex->pprev;
+  return pindex->getDifficulty();
+}
+
 // copied from BTC
 template <>
 uint32_t getNextWorkRequired(const BlockIndex<BtcBlock>& prevBlock,
                              const BtcBlock& block,
-                             const BtcChainParams& params) {
+                             const BtcChainParams& params,
+                             const ChainWindow<BtcBlock>* window) {
   unsigned int nProofOfWorkLimit = ArithUint256(params.getPowLimit()).toBits();
 
   // Only change once per difficulty adjustment interval
@@ -91,12 +107,8 @@ uint32_t getNextWorkRequired(const BlockIndex<BtcBlock>& prevBlock,
         return nProofOfWorkLimit;
       } else {
         // Return the last non-special-min-difficulty-rules-block
-        const BlockIndex<BtcBlock>* pindex = &prevBlock;
-        while (pindex->pprev &&
-               pindex->height % params.getDifficultyAdjustmentInterval() != 0 &&
-               pindex->getDifficulty() == nProofOfWorkLimit)
-          pindex = pindex->pprev;
-        return pindex->getDifficulty();
+        return window != nullptr ? window->retarget.lastNonMinDifficulty
+                                 : getLastNonMinDifficulty(prevBlock, params);
       }
     }
     return prevBlock.getDifficulty();
@@ -115,28 +127,33 @@ uint32_t getNextWorkRequired(const BlockIndex<BtcBlock>& prevBlock,
 }
 
 template <>
-int64_t getMedianTimePast(const BlockIndex<BtcBlock>& prev) {
-  static constexpr int medianTimeSpan = 11;
-
-  int64_t pmedian[medianTimeSpan];
-  std::fill(pmedian, pmedian + medianTimeSpan, 0);
-  auto* pbegin = &pmedian[medianTimeSpan];
-  auto* pend = &pmedian[medianTimeSpan];
-
-  const BlockIndex<BtcBlock>* pindex = &prev;
-  for (int i = 0; i < medianTimeSpan && pindex; i++, pindex = pindex->pprev) {
-    *(--pbegin) = pindex->getBlockTime();
+void buildRetargetWindow(const BlockIndex<BtcBlock>& index,
+                         const ChainWindow<BtcBlock>* prev,
+                         const BtcChainParams& params,
+                         ChainWindow<BtcBlock>& window) {
+  unsigned int nProofOfWorkLimit = ArithUint256(params.getPowLimit()).toBits();
+  if (prev != nullptr && index.pprev != nullptr &&
+      index.height % params.getDifficultyAdjustmentInterval() != 0 &&
+      index.getDifficulty() == nProofOfWorkLimit) {
+    window.retarget.lastNonMinDifficulty = prev->retarget.lastNonMinDifficulty;
+  } else {
+    window.retarget.lastNonMinDifficulty =
+        getLastNonMinDifficulty(index, params);
   }
+}
 
-  std::sort(pbegin, pend);
-  return pbegin[(pend - pbegin) / 2];
+template <>
+int64_t getMedianTimePast(const BlockIndex<BtcBlock>& prev,
+                          const ChainWindow<BtcBlock>* window) {
+  return getSortedTime(prev, window, [](size_t size) { return size / 2; });
 }
 
 template <>
 bool checkBlockTime(const BlockIndex<BtcBlock>& prev,
                     const BtcBlock& block,
-                    ValidationState& state) {
-  if (int64_t(block.getBlockTime()) < getMedianTimePast(prev)) {
+                    ValidationState& state,
+                    const ChainWindow<BtcBlock>* window) {
+  if (int64_t(block.getBlockTime()) < getMedianTimePast(prev, window)) {
     return state.Invalid("btc-time-too-old", "block's timestamp is too early");
   }
 
@@ -153,13 +170,15 @@ template <>
 bool contextuallyCheckBlock(const BlockIndex<BtcBlock>& prev,
                             const BtcBlock& block,
                             ValidationState& state,
-                            const BtcChainParams& params) {
-  if (block.getDifficulty() != getNextWorkRequired(prev, block, params)) {
+                            const BtcChainParams& params,
+                            const ChainWindow<BtcBlock>* window) {
+  if (block.getDifficulty() !=
+      getNextWorkRequired(prev, block, params, window)) {
     return state.Invalid("btc-bad-diffbits",
                          "incorrect proof of work of BTC block");
   }
 
-  if (!checkBlockTime(prev, block, state)) {
+  if (!checkBlockTime(prev, block, state, window)) {
     return state.Invalid("btc-check-block-time");
   }
 
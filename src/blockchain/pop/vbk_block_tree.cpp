@@ -17,7 +17,7 @@ void VbkBlockTree::determineBestChain(Chain<index_t>& currentBest,
   }
 
   if (currentBest.tip() == nullptr) {
-    currentBest.setTip(&indexNew);
+    setActiveTip(currentBest, &indexNew);
     return onTipChanged(indexNew, isBootstrap);
   }
 
@@ -45,7 +45,7 @@ void VbkBlockTree::determineBestChain(Chain<index_t>& currentBest,
   if (result < 0) {
     // other chain won!
     auto* prevTip = currentBest.tip();
-    currentBest.setTip(&indexNew);
+    setActiveTip(currentBest, &indexNew);
     onTipChanged(indexNew, isBootstrap);
     addForkCandidate(prevTip, &indexNew);
   } else if (result == 0) {
@@ -103,6 +103,34 @@ void VbkBlockTree::invalidateBlockByHash(const hash_t& blockHash) {
   (void)ret;
 }
 
+bool VbkBlockTree::loadBlocks(const std::vector<index_t>& blocks,
+                              const hash_t* tip,
+                              ValidationState& state) {
+  if (!VbkTree::loadBlocks(blocks, tip, state)) {
+    return state.Invalid("vbk-load-blocks");
+  }
+
+  std::vector<index_t*> loaded;
+  loaded.reserve(valid_blocks.size() + failed_blocks.size());
+  for (const auto& block : valid_blocks) {
+    loaded.push_back(block.second);
+  }
+  for (const auto& block : failed_blocks) {
+    loaded.push_back(block.second);
+  }
+
+  if (!cmp_.restore(*activeChain_.tip(), loaded, state)) {
+    return state.Invalid("vbk-restore-comparator");
+  }
+
+  return true;
+}
+
+void VbkBlockTree::setUndoLog(UndoLog* log) {
+  VbkTree::setUndoLog(log);
+  cmp_.setUndoLog(log);
+}
+
 bool VbkBlockTree::addPayloads(PopForkComparator& cmp,
                                const VbkBlock& block,
                                const std::vector<payloads_t>& payloads,
@@ -116,18 +144,11 @@ bool VbkBlockTree::addPayloads(PopForkComparator& cmp,
   if (!cmp.addPayloads(*index, payloads, state)) {
     return state.Invalid("bad-payloads-stateful");
   }
+  changed_.insert(index);
 
-  // if this index is the part of the some fork_chain set to the tip of that
-  // fork for the correct determineBestChain() processing
-  std::vector<index_t*> forkTips;
-  for (const auto& forkChain : fork_chains_) {
-    if (forkChain.second.contains(index) ||
-        forkChain.second.tip()->getAncestor(index->height) == index) {
-      forkTips.push_back(forkChain.second.tip());
-    }
-  }
-
-  for (const auto& tip : forkTips) {
+  // if this index is the part of some fork, set it to the tip of that fork
+  // for the correct determineBestChain() processing
+  for (auto* tip : fork_candidates_.getDescendantsOf(*index)) {
     determineBestChain(activeChain_, *tip);
   }
 
@@ -146,6 +167,7 @@ void VbkBlockTree::removePayloads(index_t* index,
                                   const std::vector<payloads_t>& payloads) {
   assert(index);
   cmp_.removePayloads(*index, payloads);
+  changed_.insert(index);
 
   determineBestChain(activeChain_, *index);
 }
@@ -158,14 +180,9 @@ bool VbkBlockTree::addPayloads(const VbkBlock& block,
     return addPayloads(cmp_, block, payloads, state);
   }
 
-  // execute addPayloads on a temp copy
-  PopForkComparator cmp = cmp_;
-  bool ret = addPayloads(cmp, block, payloads, state);
-  if (ret) {
-    // if succeded, update local copy
-    cmp_ = cmp;
-  }
-  return ret;
+  // journal all changes, and revert them if payloads are invalid
+  return tryValidateWithUndoLog(
+      *this, [&]() { return addPayloads(cmp_, block, payloads, state); });
 }
 
 std::string VbkBlockTree::toPrettyString(size_t level) const {
@@ -182,14 +199,15 @@ bool VbkBlockTree::PopForkComparator::sm_t::applyContext(
     const BlockIndex<VbkBlock>& index, ValidationState& state) {
   return tryValidateWithResources(
       [&]() -> bool {
-        size_t i = 0;
-        for (const auto& el : index.containingContext.btc_context) {
-          for (const auto& b : el.second) {
-            if (!tree().acceptBlock(b, state)) {
-              return state.Invalid("vbk-accept-block", i);
-            }
-            i++;
-          }
+        std::vector<std::shared_ptr<BtcBlock>> blocks;
+        const auto& ctx = index.getPopData().containingContext;
+        for (const auto& el : ctx.btc_context) {
+          blocks.insert(blocks.end(), el.second.begin(), el.second.end());
+        }
+
+        // context is applied on every fork comparison, do not spawn threads
+        if (!tree().acceptBlocks(blocks, state, false)) {
+          return state.Invalid("vbk-accept-block");
         }
 
         return true;
@@ -202,7 +220,7 @@ void VbkBlockTree::PopForkComparator::sm_t::unapplyContext(
     const BlockIndex<VbkBlock>& index) {
   // unapply in "forward" order, because result should be same, but doing this
   // way it should be faster due to less number of calls "determineBestChain"
-  for (const auto& el : index.containingContext.btc_context) {
+  for (const auto& el : index.getPopData().containingContext.btc_context) {
     for (const auto& b : el.second) {
       tree().invalidateBlockByHash(b->getHash());
     }
@@ -215,7 +233,7 @@ void removeContextFromBlockIndex(BlockIndex<VbkBlock>& index,
                                  const BlockIndex<VbkBlock>::payloads_t& p) {
   using eid_t = typename BlockIndex<VbkBlock>::eid_t;
 
-  auto& ctx = index.containingContext.btc_context;
+  auto& ctx = index.touchPopData().containingContext.btc_context;
   auto end = ctx.end();
 
   end = std::remove_if(
@@ -232,7 +250,7 @@ template <>
 void addContextToBlockIndex(BlockIndex<VbkBlock>& index,
                             const typename BlockIndex<VbkBlock>::payloads_t& p,
                             const BlockTree<BtcBlock, BtcChainParams>& tree) {
-  auto& ctx = index.containingContext;
+  auto& ctx = index.touchPopData().containingContext;
 
   std::unordered_set<BtcBlock::hash_t> known_blocks;
   for (const auto& e : ctx.btc_context) {
@@ -25,7 +25,9 @@ ArithUint256 getBlockProof(const VbkBlock& block) {
 
 template <>
 VbkBlock Miner<VbkBlock, VbkChainParams>::getBlockTemplate(
-    const BlockIndex<VbkBlock>& tip, const merkle_t& merkle) {
+    const BlockIndex<VbkBlock>& tip,
+    const merkle_t& merkle,
+    const ChainWindow<VbkBlock>* window) {
   VbkBlock block;
   block.version = tip.header->version;
   block.previousBlock =
@@ -59,14 +61,87 @@ VbkBlock Miner<VbkBlock, VbkChainParams>::getBlockTemplate(
   }
 
   block.timestamp = std::max(tip.getBlockTime(), currentTimestamp4());
-  block.difficulty = getNextWorkRequired(tip, block, params_);
+  block.difficulty = getNextWorkRequired(tip, block, params_, window);
   return block;
 }
 
+//! @return solve time of `index`, limited to 6 target block times
+static int32_t getSolveTime(const BlockIndex<VbkBlock>& index,
+                            const VbkChainParams& params) {
+  assert(index.pprev != nullptr);
+  int32_t solveTime = index.getBlockTime() - index.pprev->getBlockTime();
+
+  if (solveTime > (int32_t)(params.getTargetBlockTime() * 6)) {
+    solveTime = params.getTargetBlockTime() * 6;
+  } else if (solveTime < -6 * (int32_t)params.getTargetBlockTime()) {
+    solveTime = -6 * (int32_t)params.getTargetBlockTime();
+  }
+
+  return solveTime;
+}
+
+//! walk last blocks of the chain, which ends at `prevBlock`, to sum their
+//! solve times and targets
+static RetargetWindow<VbkBlock> collectRetargetWindow(
+    const BlockIndex<VbkBlock>& prevBlock, const VbkChainParams& params) {
+  RetargetWindow<VbkBlock> window;
+  uint32_t& i = window.count;
+
+  for (const BlockIndex<VbkBlock>* workBlock = &prevBlock;
+       i < params.getRetargetPeriod() - 1 && workBlock->pprev != nullptr;
+       ++i, workBlock = workBlock->pprev) {
+    int32_t solveTime = getSolveTime(*workBlock, params);
+    window.weightedSolveTime +=
+        solveTime * (params.getRetargetPeriod() - i - 1);
+    window.solveTime += solveTime;
+    window.target += ArithUint256::fromBits(workBlock->pprev->getDifficulty());
+  }
+
+  return window;
+}
+
+template <>
+void buildRetargetWindow(const BlockIndex<VbkBlock>& index,
+                         const ChainWindow<VbkBlock>* prevWindow,
+                         const VbkChainParams& params,
+                         ChainWindow<VbkBlock>& window) {
+  auto& cache = window.retarget;
+  const auto* prev = index.pprev;
+  if (prev == nullptr || prevWindow == nullptr) {
+    cache = collectRetargetWindow(index, params);
+    return;
+  }
+
+  // slide window of the previous block by one block: weights of all solve
+  // times in it decrease by one, new solve time gets the highest weight
+  const auto& prevCache = prevWindow->retarget;
+  const uint32_t size = params.getRetargetPeriod() - 1;
+  int32_t solveTime = getSolveTime(index, params);
+  cache = prevCache;
+  cache.weightedSolveTime += solveTime * (int32_t)size - prevCache.solveTime;
+  cache.solveTime += solveTime;
+  cache.target += ArithUint256::fromBits(prev->getDifficulty());
+
+  if (prevCache.count < size) {
+    ++cache.count;
+    return;
+  }
+
+  // the oldest block leaves the window
+  const auto* oldest = prev->getAncestor(index.height - (int32_t)size);
+  if (oldest == nullptr || oldest->pprev == nullptr) {
+    cache = collectRetargetWindow(index, params);
+    return;
+  }
+  cache.solveTime -= getSolveTime(*oldest, params);
+  cache.target -= ArithUint256::fromBits(oldest->pprev->getDifficulty());
+}
+
 template <>
 uint32_t getNextWorkRequired(const BlockIndex<VbkBlock>& prevBlock,
                              const VbkBlock&,
-                             const VbkChainParams& params) {
+                             const VbkChainParams& params,
+                             const ChainWindow<VbkBlock>* cached) {
   static const uint32_t K = params.getRetargetPeriod() *
                             (params.getRetargetPeriod() - 1) *
                             params.getTargetBlockTime() / 2;
@@ -76,26 +151,11 @@ uint32_t getNextWorkRequired(const BlockIndex<VbkBlock>& prevBlock,
     return prevBlock.getDifficulty();
   }
 
-  ArithUint256 targetDif = 0;
-  int32_t t = 0;
-  uint32_t i = 0;
-
-  for (const BlockIndex<VbkBlock>* workBlock = &prevBlock;
-       i < params.getRetargetPeriod() - 1 && workBlock->pprev != nullptr;
-       ++i, workBlock = workBlock->pprev) {
-    int32_t solveTime =
-        workBlock->getBlockTime() - workBlock->pprev->getBlockTime();
-
-    if (solveTime > (int32_t)(params.getTargetBlockTime() * 6)) {
-      solveTime = params.getTargetBlockTime() * 6;
-    } else if (solveTime < -6 * (int32_t)params.getTargetBlockTime()) {
-      solveTime = -6 * (int32_t)params.getTargetBlockTime();
-    }
-
-    t += solveTime * (params.getRetargetPeriod() - i - 1);
-
-    targetDif += ArithUint256::fromBits(workBlock->pprev->getDifficulty());
-  }
+  const auto window = cached != nullptr
+                          ? cached->retarget
+                          : collectRetargetWindow(prevBlock, params);
+  ArithUint256 targetDif = window.target;
+  int32_t t = window.weightedSolveTime;
 
   targetDif *= 1000000000;
   targetDif /= (params.getRetargetPeriod() - 1);
@@ -174,22 +234,24 @@ bool validateKeystones(const BlockIndex<VbkBlock>& prevBlock,
   return true;
 }
 
-int64_t getMedianTimePast(const BlockIndex<VbkBlock>& prev) {
+int64_t getMedianTimePast(const BlockIndex<VbkBlock>& prev,
+                          const ChainWindow<VbkBlock>* window) {
   // height of block to be added is prev.height + 1
 
   // at block 110000 VBK enables different algorithm of median time calculation,
   // which is implemented in `calculateMinimumTimestamp`. if you even encounter
   // time error on legacy (pre-110000) VBK mainnet/testnet blocks, you will need
   // to add `calculateMinimumTimestampLegacy` from VBK here.
-  return calculateMinimumTimestamp(prev);
+  return calculateMinimumTimestamp(prev, window);
 }
 
 template <>
 bool checkBlockTime(const BlockIndex<VbkBlock>& prev,
                     const VbkBlock& block,
-                    ValidationState& state) {
+                    ValidationState& state,
+                    const ChainWindow<VbkBlock>* window) {
   int64_t blockTime = block.getBlockTime();
-  int64_t median = getMedianTimePast(prev);
+  int64_t median = getMedianTimePast(prev, window);
   if (blockTime < median) {
     return state.Invalid("vbk-time-too-old", "block's timestamp is too early");
   }
@@ -203,37 +265,28 @@ bool checkBlockTime(const BlockIndex<VbkBlock>& prev,
   return true;
 }
 
-int64_t calculateMinimumTimestamp(const BlockIndex<VbkBlock>& prev) {
-  // Calculate the MEDIAN. If there are an even number of elements,
-  // use the lower of the two.
-
-  size_t i = 0;
-  std::vector<int64_t> pmedian;
-  const BlockIndex<VbkBlock>* pindex = &prev;
-  for (i = 0; i < HISTORY_FOR_TIMESTAMP_AVERAGE; i++, pindex = pindex->pprev) {
-    if (pindex == nullptr) {
-      break;
-    }
-    pmedian.push_back(pindex->getBlockTime());
-  }
-
-  assert(i > 0);
-  assert(!pmedian.empty());
-  std::sort(pmedian.begin(), pmedian.end());
-  size_t index = i % 2 == 0 ? (i / 2) - 1 : (i / 2);
-  return pmedian.at(index);
+int64_t calculateMinimumTimestamp(const BlockIndex<VbkBlock>& prev,
+                                  const ChainWindow<VbkBlock>* window) {
+  // Calculate the MEDIAN of last HISTORY_FOR_TIMESTAMP_AVERAGE blocks. If
+  // there are an even number of elements, use the lower of the two.
+  return getSortedTime(prev, window, [](size_t size) {
+    assert(size > 0);
+    return size % 2 == 0 ? (size / 2) - 1 : (size / 2);
+  });
 }
 
 template <>
 bool contextuallyCheckBlock(const BlockIndex<VbkBlock>& prev,
                             const VbkBlock& block,
                             ValidationState& state,
-                            const VbkChainParams& params) {
-  if (!checkBlockTime(prev, block, state)) {
+                            const VbkChainParams& params,
+                            const ChainWindow<VbkBlock>* window) {
+  if (!checkBlockTime(prev, block, state, window)) {
     return state.Invalid("vbk-check-block-time");
   }
 
-  if (block.getDifficulty() != getNextWorkRequired(prev, block, params)) {
+  if (block.getDifficulty() !=
+      getNextWorkRequired(prev, block, params, window)) {
     return state.Invalid("vbk-bad-diffbits", "incorrect proof of work");
   }
 
@@ -48,3 +48,9 @@ std::vector<uint8_t> AltBlock::toVbkEncoding() const {
   toVbkEncoding(stream);
   return stream.data();
 }
+
+AltBlock AltBlock::fromRaw(ReadStream& stream) {
+  return fromVbkEncoding(stream);
+}
+
+void AltBlock::toRaw(WriteStream& stream) const { toVbkEncoding(stream); }
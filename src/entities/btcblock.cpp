@@ -45,7 +45,7 @@ void BtcBlock::toVbkEncoding(WriteStream& stream) const {
 }
 
 uint256 BtcBlock::getHash() const {
-  WriteStream stream;
+  WriteStream stream(BTC_HEADER_SIZE);
   toRaw(stream);
   return sha256twice(stream.data()).reverse();
 }
@@ -9,6 +9,15 @@
 
 namespace altintegration {
 
+//! read array of context blocks, written in VBK encoding
+template <typename Block>
+static std::vector<std::shared_ptr<Block>> readBlocks(ReadStream& stream) {
+  return readArrayOf<std::shared_ptr<Block>>(
+      stream, 0, MAX_CONTEXT_COUNT, [](ReadStream& s) {
+        return std::make_shared<Block>(Block::fromVbkEncoding(s));
+      });
+}
+
 PartialVTB PartialVTB::fromVTB(const VTB& vtb) {
   PartialVTB p_vtb;
   p_vtb.endorsement = BtcEndorsement::fromContainer(vtb);
@@ -46,6 +55,65 @@ typename BtcEndorsement::id_t PartialVTB::getEndorsementId() const {
   return endorsement.id;
 }
 
+void PartialVTB::toRaw(WriteStream& stream) const {
+  writeSingleBEValue(stream, btc.size());
+  for (const auto& block : btc) {
+    block->toVbkEncoding(stream);
+  }
+  containing->toVbkEncoding(stream);
+  endorsement.toRaw(stream);
+}
+
+PartialVTB PartialVTB::fromRaw(ReadStream& stream) {
+  PartialVTB p_vtb;
+  p_vtb.btc = readBlocks<BtcBlock>(stream);
+  p_vtb.containing =
+      std::make_shared<VbkBlock>(VbkBlock::fromVbkEncoding(stream));
+  p_vtb.endorsement = BtcEndorsement::fromRaw(stream);
+  return p_vtb;
+}
+
+void VbkContext::toRaw(WriteStream& stream) const {
+  writeSingleBEValue(stream, btc_context.size());
+  for (const auto& el : btc_context) {
+    writeSingleByteLenValue(stream, el.first);
+    writeSingleBEValue(stream, el.second.size());
+    for (const auto& block : el.second) {
+      block->toVbkEncoding(stream);
+    }
+  }
+}
+
+VbkContext VbkContext::fromRaw(ReadStream& stream) {
+  using el_t = std::pair<eid_t, std::vector<std::shared_ptr<BtcBlock>>>;
+  VbkContext ctx;
+  ctx.btc_context = readArrayOf<el_t>(
+      stream, 0, MAX_CONTEXT_COUNT, [](ReadStream& s) -> el_t {
+        eid_t id = readSingleByteLenValue(s, eid_t::size(), eid_t::size());
+        return {id, readBlocks<BtcBlock>(s)};
+      });
+  return ctx;
+}
+
+void AltContext::toRaw(WriteStream& stream) const {
+  writeSingleBEValue(stream, vbk.size());
+  for (const auto& block : vbk) {
+    block->toVbkEncoding(stream);
+  }
+  writeSingleBEValue(stream, vtbs.size());
+  for (const auto& vtb : vtbs) {
+    vtb.toRaw(stream);
+  }
+}
+
+AltContext AltContext::fromRaw(ReadStream& stream) {
+  AltContext ctx;
+  ctx.vbk = readBlocks<VbkBlock>(stream);
+  ctx.vtbs = readArrayOf<PartialVTB>(
+      stream, 0, MAX_CONTEXT_COUNT, PartialVTB::fromRaw);
+  return ctx;
+}
+
 bool operator==(const PartialVTB& a, const PartialVTB& b) {
   return a.endorsement == b.endorsement && *a.containing == *b.containing;
 }
@@ -57,7 +57,7 @@ uint32_t VbkBlock::getDifficulty() const { return difficulty; }
 uint32_t VbkBlock::getBlockTime() const { return timestamp; }
 
 VbkBlock::hash_t VbkBlock::getHash() const {
-  WriteStream stream;
+  WriteStream stream(VBK_HEADER_SIZE);
   toRaw(stream);
   return vblake(stream.data());
 }
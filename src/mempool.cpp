@@ -98,9 +98,18 @@ bool MemPool::applyPayloads(const AltBlock& hack_block,
         genesis_height, containing_block_index->height - settlement_interval);
 
     auto endorsement = BtcEndorsement::fromContainer(vtb);
-    Chain<BlockIndex<VbkBlock>> chain(start_height, containing_block_index);
-    auto duplicate =
-        chain.findBlockContainingEndorsement(endorsement, settlement_interval);
+    // same as walking back 'settlement_interval' blocks from containing block
+    // till endorsed block
+    start_height = std::max(
+        start_height, containing_block_index->height - settlement_interval + 1);
+    auto* endorsed =
+        containing_block_index->getAncestor(endorsement.endorsedHeight);
+    if (endorsed != nullptr &&
+        endorsed->getHash() == endorsement.endorsedHash) {
+      start_height = std::max(start_height, endorsement.endorsedHeight + 1);
+    }
+    auto duplicate = tree.vbk().getComparator().getEndorsementIndex().find(
+        endorsement.id, *containing_block_index, start_height);
 
     // invalid vtb
     if (duplicate) {
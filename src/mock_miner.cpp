@@ -31,7 +31,9 @@ bool mineBlocks(const uint32_t& n,
     auto* tip = blockChain.getBestChain().tip();
     assert(tip != nullptr && "block tree is not bootstrapped");
 
-    Block block = miner.createNextBlock(*tip);
+    ChainWindow<Block> window;
+    bool hasWindow = blockChain.getChainWindow(*tip, window);
+    Block block = miner.createNextBlock(*tip, hasWindow ? &window : nullptr);
     if (!blockChain.acceptBlock(block, state)) {
       return false;
     }
@@ -317,7 +319,10 @@ BlockIndex<BtcBlock>* MockMiner::mineBtcBlocks(const BlockIndex<BtcBlock>& tip,
   for (size_t i = 0; i < amount; i++) {
     auto* index = vbktree.btc().getBlockIndex(last);
     assert(index);
-    auto block = btc_miner.createNextBlock(*index);
+    ChainWindow<BtcBlock> window;
+    bool hasWindow = vbktree.btc().getChainWindow(*index, window);
+    auto block =
+        btc_miner.createNextBlock(*index, hasWindow ? &window : nullptr);
     if (!vbktree.btc().acceptBlock(block, state_)) {
       throw std::domain_error(state_.GetDebugMessage());
     }
@@ -345,7 +350,10 @@ BlockIndex<VbkBlock>* MockMiner::mineVbkBlocks(const BlockIndex<VbkBlock>& tip,
   for (size_t i = 0; i < amount; i++) {
     auto* index = vbktree.getBlockIndex(last);
     assert(index);
-    auto block = vbk_miner.createNextBlock(*index);
+    ChainWindow<VbkBlock> window;
+    bool hasWindow = vbktree.getChainWindow(*index, window);
+    auto block =
+        vbk_miner.createNextBlock(*index, hasWindow ? &window : nullptr);
     if (!vbktree.acceptBlock(block, state_)) {
       throw std::domain_error(state_.GetDebugMessage());
     }
@@ -5,6 +5,7 @@
 
 #include <cassert>
 #include <vector>
+#include <veriblock/blockchain/pop/pop_utils.hpp>
 #include <veriblock/entities/atv.hpp>
 #include <veriblock/rewards/poprewards.hpp>
 #include <veriblock/rewards/poprewards_calculator.hpp>
@@ -14,8 +15,8 @@ namespace altintegration {
 static int getBestPublicationHeight(const BlockIndex<AltBlock>& endorsedBlock,
                                     const VbkBlockTree& vbk_tree) {
   int bestPublication = -1;
-  for (const auto* e : endorsedBlock.endorsedBy) {
-    auto* b = vbk_tree.getBlockIndex(e->blockOfProof);
+  for (const auto* e : endorsedBlock.getPopData().endorsedBy) {
+    auto* b = resolveBlockOfProof(*e, vbk_tree);
     if (!vbk_tree.getBestChain().contains(b)) continue;
     if (b->height < bestPublication || bestPublication < 0)
       bestPublication = b->height;
@@ -31,8 +32,8 @@ PopRewardsBigDecimal PopRewards::scoreFromEndorsements(
   int bestPublication = getBestPublicationHeight(endorsedBlock, vbk_tree);
   if (bestPublication < 0) return totalScore;
 
-  for (const auto* e : endorsedBlock.endorsedBy) {
-    auto* b = vbk_tree.getBlockIndex(e->blockOfProof);
+  for (const auto* e : endorsedBlock.getPopData().endorsedBy) {
+    auto* b = resolveBlockOfProof(*e, vbk_tree);
     if (!vbk_tree.getBestChain().contains(b)) continue;
     int relativeHeight = b->height - bestPublication;
     assert(relativeHeight >= 0);
@@ -77,8 +78,8 @@ std::map<std::vector<uint8_t>, int64_t> PopRewards::calculatePayouts(
   auto blockScore = scoreFromEndorsements(vbk_tree, endorsedBlock);
 
   // pay reward for each of the endorsements
-  for (const auto* e : endorsedBlock.endorsedBy) {
-    auto* b = vbk_tree.getBlockIndex(e->blockOfProof);
+  for (const auto* e : endorsedBlock.getPopData().endorsedBy) {
+    auto* b = resolveBlockOfProof(*e, vbk_tree);
     if (!vbk_tree.getBestChain().contains(b)) continue;
 
     int veriBlockHeight = b->height;
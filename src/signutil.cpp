@@ -3,7 +3,10 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <random>
 #include <utility>
 
 #include "veriblock/hashutil.hpp"
@@ -16,10 +19,24 @@ namespace altintegration {
 struct Secp256k1Context {
   secp256k1_context* ctx;
 
-  Secp256k1Context(unsigned int flags) {
-    ctx = secp256k1_context_create(flags);
+  Secp256k1Context() {
+    ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN |
+                                   SECP256K1_CONTEXT_VERIFY);
+
+    // randomize once, before the context is shared between threads. This
+    // blinds signing against side-channel attacks.
+    std::random_device rd;
+    std::array<uint8_t, 32> seed{};
+    std::generate(seed.begin(), seed.end(), [&rd]() { return (uint8_t)rd(); });
+    int randomized = secp256k1_context_randomize(ctx, seed.data());
+    // should be always 1
+    assert(randomized == 1);
+    (void)randomized;
   }
 
+  Secp256k1Context(const Secp256k1Context&) = delete;
+  Secp256k1Context& operator=(const Secp256k1Context&) = delete;
+
   ~Secp256k1Context() {
     if (ctx) {
       secp256k1_context_destroy(ctx);
@@ -27,9 +44,19 @@ struct Secp256k1Context {
     }
   }
 
-  operator secp256k1_context*() const { return ctx; }
+  operator const secp256k1_context*() const { return ctx; }
 };
 
+/**
+ * Process-wide secp256k1 context. Building precomputation tables is
+ * expensive, so it is done once on first use. secp256k1 functions which
+ * accept a const context are safe to call concurrently.
+ */
+static const Secp256k1Context& getContext() {
+  static const Secp256k1Context ctx;
+  return ctx;
+}
+
 static const std::string ASN1_PREFIX_PRIVKEY =
     "303E020100301006072A8648CE3D020106052B8104000A042730250201010420";
 static const auto ASN1_PREFIX_PRIVKEY_BYTES = ParseHex(ASN1_PREFIX_PRIVKEY);
@@ -60,7 +87,7 @@ static PrivateKey getPrivateKeyFromAsn1(Slice<const uint8_t> keyEncoded) {
 
 static PublicKey publicKeyUncompress(Slice<const uint8_t> publicKey) {
   assert(publicKey.size() == PUBLIC_KEY_COMPRESSED_SIZE);
-  Secp256k1Context ctx(SECP256K1_CONTEXT_SIGN);
+  const auto& ctx = getContext();
   secp256k1_pubkey pubkey;
   if (!secp256k1_ec_pubkey_parse(
           ctx, &pubkey, publicKey.data(), publicKey.size())) {
@@ -139,7 +166,7 @@ PublicKeyVbk publicKeyToVbk(PublicKey key) {
 }
 
 PublicKey derivePublicKey(PrivateKey privateKey) {
-  Secp256k1Context ctx(SECP256K1_CONTEXT_SIGN);
+  const auto& ctx = getContext();
   secp256k1_pubkey pubkey;
   int pubCreated = secp256k1_ec_pubkey_create(ctx, &pubkey, privateKey.data());
   // should be always 1
@@ -157,7 +184,7 @@ PublicKey derivePublicKey(PrivateKey privateKey) {
 }
 
 Signature veriBlockSign(Slice<const uint8_t> message, PrivateKey privateKey) {
-  Secp256k1Context ctx(SECP256K1_CONTEXT_SIGN);
+  const auto& ctx = getContext();
   auto messageHash = sha256(message);
 
   secp256k1_ecdsa_signature signature;
@@ -175,7 +202,7 @@ Signature veriBlockSign(Slice<const uint8_t> message, PrivateKey privateKey) {
 int veriBlockVerify(Slice<const uint8_t> message,
                     Signature signature,
                     PublicKey publicKey) {
-  Secp256k1Context ctx(SECP256K1_CONTEXT_VERIFY);
+  const auto& ctx = getContext();
   secp256k1_pubkey pubkey;
   if (!secp256k1_ec_pubkey_parse(
           ctx, &pubkey, publicKey.data(), publicKey.size())) {
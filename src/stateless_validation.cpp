@@ -14,6 +14,7 @@
 #include "veriblock/arith_uint256.hpp"
 #include "veriblock/blob.hpp"
 #include "veriblock/consts.hpp"
+#include "veriblock/hashutil.hpp"
 #include "veriblock/strutil.hpp"
 
 namespace {
@@ -269,6 +270,31 @@ bool checkVbkTx(const VbkTx& tx, ValidationState& state) {
   return true;
 }
 
+ValidationCache& getSignatureCache() {
+  static ValidationCache cache;
+  return cache;
+}
+
+// signature check result depends only on the signed hash, the signature and
+// the public key, so it is cached by all three
+static bool verifyWithCache(const uint256& hash,
+                            const Signature& signature,
+                            const PublicKeyVbk& publicKey) {
+  auto& cache = getSignatureCache();
+  const auto sigHash = sha256(signature, publicKey);
+  const auto key = sha256(hash, sigHash);
+  if (cache.contains(key)) {
+    return true;
+  }
+
+  if (!veriBlockVerify(hash, signature, publicKeyFromVbk(publicKey))) {
+    return false;
+  }
+
+  cache.insert(key);
+  return true;
+}
+
 bool checkSignature(const VbkTx& tx, ValidationState& state) {
   if (!tx.sourceAddress.isDerivedFromPublicKey(tx.publicKey)) {
     return state.Invalid("invalid-vbk-tx",
@@ -276,7 +302,7 @@ bool checkSignature(const VbkTx& tx, ValidationState& state) {
   }
 
   auto hash = tx.getHash();
-  if (!veriBlockVerify(hash, tx.signature, publicKeyFromVbk(tx.publicKey))) {
+  if (!verifyWithCache(hash, tx.signature, tx.publicKey)) {
     return state.Invalid("invalid-vbk-tx",
                          "Vbk transaction is incorrectly signed");
   }
@@ -289,7 +315,7 @@ bool checkSignature(const VbkPopTx& tx, ValidationState& state) {
                          "Vbk Pop transaction contains an invalid public key");
   }
   auto hash = tx.getHash();
-  if (!veriBlockVerify(hash, tx.signature, publicKeyFromVbk(tx.publicKey))) {
+  if (!verifyWithCache(hash, tx.signature, tx.publicKey)) {
     return state.Invalid("invalid-vbk-pop-tx",
                          "Vbk Pop transaction is incorrectly signed");
   }
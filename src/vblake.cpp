@@ -3,12 +3,29 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
-// A simple vblake Reference Implementation.
+// A simple vblake Reference Implementation, with SSE2 and AVX2 versions of
+// the compression function, selected at runtime.
 
 #include <veriblock/vblake.h>
 
+#include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define VBLAKE_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC allows intrinsics of any instruction set without special flags
+#define VBLAKE_TARGET_AVX2
+#else
+#define VBLAKE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define VBLAKE_X86_SIMD 0
+#endif
 
 #ifndef _countof
 #define _countof(x) (sizeof(x) / sizeof(x[0]))
@@ -106,14 +123,39 @@ static void vblake_B2B_G(uint64_t *v,
           (v[a] & ~v[b] & ~v[c]) | (v[a] & v[b] & v[c]);
 }
 
+//
+// Load message words of the input block, mixed with the round constants.
+// Words 8..15 of the message are always zero.
+//
+static void vblake_load_message(const vblake_ctx *ctx, uint64_t *mc) {
+  for (uint32_t i = 0; i < 16; i++) {
+    uint64_t m = 0;
+    if (i < 8) {
+      for (uint32_t j = 0; j < 8; j++) {
+        m ^= (uint64_t)(ctx->b[i * 8u + j] & 0xFFu) << (8u * j);
+      }
+    }
+    mc[i] = m ^ vblake_c[i];
+  }
+}
+
+//
+// Final step of the compression, after v[0..15] are mixed into h[0..7]
+//
+static inline void vblake_fold_state(vblake_ctx *ctx) {
+  ctx->h[0] ^= ctx->h[3] ^ ctx->h[6];
+  ctx->h[1] ^= ctx->h[4] ^ ctx->h[7];
+  ctx->h[2] ^= ctx->h[5];
+}
+
 //==========================================================================================
 //                       WORK UNITS
 //==========================================================================================
 
 //
-// Compression function. "last" flag indicates last block.
+// Compression function, reference implementation.
 //
-static void vblake_compress(vblake_ctx *ctx) {
+static void vblake_compress_scalar(vblake_ctx *ctx) {
   uint64_t i;
   static const uint64_t kNumOfRounds = 16;
   uint64_t v[kNumOfRounds] = {};
@@ -224,9 +266,277 @@ static void vblake_compress(vblake_ctx *ctx) {
     ctx->h[i] ^= v[i] ^ v[i + 8];
   }
 
-  ctx->h[0] ^= ctx->h[3] ^ ctx->h[6];
-  ctx->h[1] ^= ctx->h[4] ^ ctx->h[7];
-  ctx->h[2] ^= ctx->h[5];
+  vblake_fold_state(ctx);
+}
+
+#if VBLAKE_X86_SIMD
+//
+// Vectorized versions keep the 4x4 matrix of work variables in rows:
+// a = v[0..3], b = v[4..7], c = v[8..11], d = v[12..15], and apply G to all
+// four columns at once, then to all four diagonals after rotating rows b, c
+// and d. Both LUT mixing steps of the scalar G together flip every bit of
+// v[d] (even parity, then odd parity of the same v[a], v[b], v[c]), so they
+// are a single NOT here.
+//
+
+//
+// SSE2: every row is split into two registers, low (0, 1) and high (2, 3)
+//
+#define VBLAKE_ROTR64_SSE2(x, n) \
+  _mm_or_si128(_mm_srli_epi64((x), (n)), _mm_slli_epi64((x), 64 - (n)))
+
+//! @return (x[1], y[0])
+static inline __m128i vblake_hilo_sse2(__m128i x, __m128i y) {
+  return _mm_castpd_si128(
+      _mm_shuffle_pd(_mm_castsi128_pd(x), _mm_castsi128_pd(y), 1));
+}
+
+static inline void vblake_G_sse2(__m128i &a,
+                                 __m128i &b,
+                                 __m128i &c,
+                                 __m128i &d,
+                                 __m128i x,
+                                 __m128i y) {
+  a = _mm_add_epi64(_mm_add_epi64(a, b), x);
+  d = VBLAKE_ROTR64_SSE2(_mm_xor_si128(d, a), 60);
+  c = _mm_add_epi64(c, d);
+  b = VBLAKE_ROTR64_SSE2(_mm_xor_si128(b, c), 43);
+  a = _mm_add_epi64(_mm_add_epi64(a, b), y);
+  d = VBLAKE_ROTR64_SSE2(_mm_xor_si128(d, a), 5);
+  c = _mm_add_epi64(c, d);
+  b = VBLAKE_ROTR64_SSE2(_mm_xor_si128(b, c), 18);
+  d = _mm_xor_si128(d, _mm_set1_epi32(-1));
+}
+
+static void vblake_compress_sse2(vblake_ctx *ctx) {
+  uint64_t mc[16];
+  vblake_load_message(ctx, mc);
+
+  auto *h = (__m128i *)ctx->h;
+  __m128i a0 = _mm_loadu_si128(h + 0);
+  __m128i a1 = _mm_loadu_si128(h + 1);
+  __m128i b0 = _mm_loadu_si128(h + 2);
+  __m128i b1 = _mm_loadu_si128(h + 3);
+  __m128i c0 = _mm_set_epi64x(vblake_iv[1], vblake_iv[0]);
+  __m128i c1 = _mm_set_epi64x(vblake_iv[3], vblake_iv[2]);
+  // input count and f[0], see vblake_compress_scalar
+  __m128i d0 = _mm_set_epi64x(vblake_iv[5], vblake_iv[4] ^ 64);
+  __m128i d1 = _mm_set_epi64x(vblake_iv[7], ~vblake_iv[6]);
+
+  for (const auto &s : sigma) {
+    // columns
+    vblake_G_sse2(a0,
+                  b0,
+                  c0,
+                  d0,
+                  _mm_set_epi64x(mc[s[3]], mc[s[1]]),
+                  _mm_set_epi64x(mc[s[2]], mc[s[0]]));
+    vblake_G_sse2(a1,
+                  b1,
+                  c1,
+                  d1,
+                  _mm_set_epi64x(mc[s[7]], mc[s[5]]),
+                  _mm_set_epi64x(mc[s[6]], mc[s[4]]));
+
+    // rotate b by 1, c by 2, d by 3 words to put diagonals into columns
+    __m128i t = vblake_hilo_sse2(b0, b1);
+    b1 = vblake_hilo_sse2(b1, b0);
+    b0 = t;
+    t = c0;
+    c0 = c1;
+    c1 = t;
+    t = vblake_hilo_sse2(d1, d0);
+    d1 = vblake_hilo_sse2(d0, d1);
+    d0 = t;
+
+    // diagonals
+    vblake_G_sse2(a0,
+                  b0,
+                  c0,
+                  d0,
+                  _mm_set_epi64x(mc[s[11]], mc[s[9]]),
+                  _mm_set_epi64x(mc[s[10]], mc[s[8]]));
+    vblake_G_sse2(a1,
+                  b1,
+                  c1,
+                  d1,
+                  _mm_set_epi64x(mc[s[15]], mc[s[13]]),
+                  _mm_set_epi64x(mc[s[14]], mc[s[12]]));
+
+    // rotate rows back
+    t = vblake_hilo_sse2(b1, b0);
+    b1 = vblake_hilo_sse2(b0, b1);
+    b0 = t;
+    t = c0;
+    c0 = c1;
+    c1 = t;
+    t = vblake_hilo_sse2(d0, d1);
+    d1 = vblake_hilo_sse2(d1, d0);
+    d0 = t;
+  }
+
+  // Update h[0 .. 7]
+  _mm_storeu_si128(
+      h + 0,
+      _mm_xor_si128(_mm_loadu_si128(h + 0), _mm_xor_si128(a0, c0)));
+  _mm_storeu_si128(
+      h + 1,
+      _mm_xor_si128(_mm_loadu_si128(h + 1), _mm_xor_si128(a1, c1)));
+  _mm_storeu_si128(
+      h + 2,
+      _mm_xor_si128(_mm_loadu_si128(h + 2), _mm_xor_si128(b0, d0)));
+  _mm_storeu_si128(
+      h + 3,
+      _mm_xor_si128(_mm_loadu_si128(h + 3), _mm_xor_si128(b1, d1)));
+
+  vblake_fold_state(ctx);
+}
+
+//
+// AVX2: every row is a single register
+//
+#define VBLAKE_ROTR64_AVX2(x, n)           \
+  _mm256_or_si256(_mm256_srli_epi64((x), (n)), \
+                  _mm256_slli_epi64((x), 64 - (n)))
+
+VBLAKE_TARGET_AVX2
+static inline void vblake_G_avx2(__m256i &a,
+                                 __m256i &b,
+                                 __m256i &c,
+                                 __m256i &d,
+                                 __m256i x,
+                                 __m256i y) {
+  a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+  d = VBLAKE_ROTR64_AVX2(_mm256_xor_si256(d, a), 60);
+  c = _mm256_add_epi64(c, d);
+  b = VBLAKE_ROTR64_AVX2(_mm256_xor_si256(b, c), 43);
+  a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+  d = VBLAKE_ROTR64_AVX2(_mm256_xor_si256(d, a), 5);
+  c = _mm256_add_epi64(c, d);
+  b = VBLAKE_ROTR64_AVX2(_mm256_xor_si256(b, c), 18);
+  d = _mm256_xor_si256(d, _mm256_set1_epi32(-1));
+}
+
+VBLAKE_TARGET_AVX2
+static void vblake_compress_avx2(vblake_ctx *ctx) {
+  uint64_t mc[16];
+  vblake_load_message(ctx, mc);
+
+  auto *h = (__m256i *)ctx->h;
+  __m256i a = _mm256_loadu_si256(h + 0);
+  __m256i b = _mm256_loadu_si256(h + 1);
+  __m256i c = _mm256_loadu_si256((const __m256i *)vblake_iv);
+  // input count and f[0], see vblake_compress_scalar
+  __m256i d =
+      _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)vblake_iv + 1),
+                       _mm256_set_epi64x(0, -1, 0, 64));
+
+  for (const auto &s : sigma) {
+    // columns
+    vblake_G_avx2(a,
+                  b,
+                  c,
+                  d,
+                  _mm256_set_epi64x(mc[s[7]], mc[s[5]], mc[s[3]], mc[s[1]]),
+                  _mm256_set_epi64x(mc[s[6]], mc[s[4]], mc[s[2]], mc[s[0]]));
+
+    // rotate b by 1, c by 2, d by 3 words to put diagonals into columns
+    b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+    c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+    d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+
+    // diagonals
+    vblake_G_avx2(a,
+                  b,
+                  c,
+                  d,
+                  _mm256_set_epi64x(mc[s[15]], mc[s[13]], mc[s[11]], mc[s[9]]),
+                  _mm256_set_epi64x(mc[s[14]], mc[s[12]], mc[s[10]], mc[s[8]]));
+
+    // rotate rows back
+    b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+    c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+    d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+  }
+
+  // Update h[0 .. 7]
+  _mm256_storeu_si256(h + 0,
+                      _mm256_xor_si256(_mm256_loadu_si256(h + 0),
+                                       _mm256_xor_si256(a, c)));
+  _mm256_storeu_si256(h + 1,
+                      _mm256_xor_si256(_mm256_loadu_si256(h + 1),
+                                       _mm256_xor_si256(b, d)));
+
+  vblake_fold_state(ctx);
+}
+
+static bool vblake_cpu_has_avx2() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+
+  // AVX must be enabled by the OS as well
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif  // VBLAKE_X86_SIMD
+
+//
+// Runtime dispatch of the compression function
+//
+typedef void (*vblake_compress_fn)(vblake_ctx *ctx);
+
+static vblake_compress_fn vblake_get_compress_fn(vblake_impl impl) {
+  switch (impl) {
+    case VBLAKE_IMPL_SCALAR:
+      return vblake_compress_scalar;
+#if VBLAKE_X86_SIMD
+    case VBLAKE_IMPL_SSE2:
+      return vblake_compress_sse2;
+    case VBLAKE_IMPL_AVX2:
+      return vblake_cpu_has_avx2() ? vblake_compress_avx2 : nullptr;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+static vblake_impl vblake_best_impl() {
+  for (auto impl : {VBLAKE_IMPL_AVX2, VBLAKE_IMPL_SSE2}) {
+    if (vblake_get_compress_fn(impl) != nullptr) {
+      return impl;
+    }
+  }
+  return VBLAKE_IMPL_SCALAR;
+}
+
+static std::atomic<vblake_impl> &vblake_current_impl() {
+  static std::atomic<vblake_impl> impl{vblake_best_impl()};
+  return impl;
+}
+
+static std::atomic<vblake_compress_fn> &vblake_current_compress() {
+  static std::atomic<vblake_compress_fn> compress{
+      vblake_get_compress_fn(vblake_current_impl().load())};
+  return compress;
+}
+
+static inline void vblake_compress(vblake_ctx *ctx) {
+  vblake_current_compress().load(std::memory_order_relaxed)(ctx);
 }
 
 static inline void vblake_create_ctx(vblake_ctx *ctx) {
@@ -283,6 +593,19 @@ int vblake_update(vblake_ctx *ctx, const void *in, size_t inlen)  // data bytes
   return 0;
 }
 
+int vblake_set_impl(vblake_impl impl) {
+  auto compress = vblake_get_compress_fn(impl);
+  if (compress == nullptr) {
+    return -1;
+  }
+
+  vblake_current_impl() = impl;
+  vblake_current_compress() = compress;
+  return 0;
+}
+
+vblake_impl vblake_get_impl(void) { return vblake_current_impl(); }
+
 //
 // Generate the message digest (size given in init).
 //      Result placed in "out".
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <ostream>
+#include <random>
 #include <string>
 
 #include "util/literals.hpp"
@@ -383,6 +384,33 @@ TEST(ArithUint256, divide) {
   ASSERT_TRUE(MaxL / R2L == ArithUint256(1));
 }
 
+TEST(ArithUint256, divideRandom) {
+  std::mt19937_64 rng(0);
+  auto random = [&](int bits) {
+    ArithUint256 ret;
+    for (int i = 0; i < 4; i++) {
+      ret <<= 64;
+      ret |= rng();
+    }
+    // number with exactly `bits` significant bits
+    return (ret >> (256 - bits)) | (OneL << (bits - 1));
+  };
+
+  for (int i = 0; i < 10000; i++) {
+    auto num = random(1 + (int)(rng() % 256));
+    auto div = random(1 + (int)(rng() % 256));
+    auto quot = num / div;
+    auto rem = num - quot * div;
+    ASSERT_LE(quot * div, num) << num.toHex() << " / " << div.toHex();
+    ASSERT_LT(rem, div) << num.toHex() << " / " << div.toHex();
+  }
+
+  // estimated quotient digit is too large and has to be corrected
+  ASSERT_EQ(ArithUint256::fromHex("7fffffff800000000000000000000000") /
+                ArithUint256::fromHex("800000000000000000000001"),
+            ArithUint256(0xfffffffe));
+}
+
 struct TestCase {
   uint32_t bits;
   uint32_t compact;
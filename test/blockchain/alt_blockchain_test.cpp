@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include "util/pop_test_fixture.hpp"
+#include "veriblock/state_utils.hpp"
+#include "veriblock/storage/block_repository_inmem.hpp"
 
 using namespace altintegration;
 
@@ -40,10 +42,10 @@ TEST_F(AltTreeFixture, invalidate_block_test1) {
   auto* endorsedBlockIndex = alttree.getBlockIndex(endorsement1.endorsedHash);
   auto* containingBlockIndex1 =
       alttree.getBlockIndex(endorsement1.containingHash);
-  EXPECT_TRUE(
-      containingBlockIndex1->containingEndorsements.find(endorsement1.id) !=
-      containingBlockIndex1->containingEndorsements.end());
-  EXPECT_EQ(endorsedBlockIndex->endorsedBy.size(), 1);
+  EXPECT_EQ(containingBlockIndex1->getPopData().containingEndorsements.count(
+                endorsement1.id),
+            1);
+  EXPECT_EQ(endorsedBlockIndex->getPopData().endorsedBy.size(), 1);
 
   // generate endorsements
   tx = popminer.endorseAltBlock(generatePublicationData(endorsedBlock));
@@ -62,10 +64,10 @@ TEST_F(AltTreeFixture, invalidate_block_test1) {
   endorsedBlockIndex = alttree.getBlockIndex(endorsement2.endorsedHash);
   auto* containingBlockIndex2 =
       alttree.getBlockIndex(endorsement2.containingHash);
-  EXPECT_TRUE(
-      containingBlockIndex2->containingEndorsements.find(endorsement2.id) !=
-      containingBlockIndex2->containingEndorsements.end());
-  EXPECT_EQ(endorsedBlockIndex->endorsedBy.size(), 2);
+  EXPECT_EQ(containingBlockIndex2->getPopData().containingEndorsements.count(
+                endorsement2.id),
+            1);
+  EXPECT_EQ(endorsedBlockIndex->getPopData().endorsedBy.size(), 2);
 
   tx = popminer.endorseAltBlock(generatePublicationData(endorsedBlock));
   containingBlock = generateNextBlock(*forkchain2.rbegin());
@@ -83,22 +85,22 @@ TEST_F(AltTreeFixture, invalidate_block_test1) {
   endorsedBlockIndex = alttree.getBlockIndex(endorsement3.endorsedHash);
   auto* containingBlockIndex3 =
       alttree.getBlockIndex(endorsement3.containingHash);
-  EXPECT_TRUE(
-      containingBlockIndex3->containingEndorsements.find(endorsement3.id) !=
-      containingBlockIndex3->containingEndorsements.end());
-  EXPECT_EQ(endorsedBlockIndex->endorsedBy.size(), 3);
+  EXPECT_EQ(containingBlockIndex3->getPopData().containingEndorsements.count(
+                endorsement3.id),
+            1);
+  EXPECT_EQ(endorsedBlockIndex->getPopData().endorsedBy.size(), 3);
 
   // remove block
   AltBlock removeBlock = chain[20];
   alttree.invalidateBlockByHash(removeBlock.getHash());
 
   containingBlockIndex3 = alttree.getBlockIndex(endorsement3.containingHash);
-  EXPECT_TRUE(
-      containingBlockIndex3->containingEndorsements.find(endorsement3.id) !=
-      containingBlockIndex3->containingEndorsements.end());
+  EXPECT_EQ(containingBlockIndex3->getPopData().containingEndorsements.count(
+                endorsement3.id),
+            1);
 
   endorsedBlockIndex = alttree.getBlockIndex(endorsement2.endorsedHash);
-  EXPECT_EQ(endorsedBlockIndex->endorsedBy.size(), 1);
+  EXPECT_EQ(endorsedBlockIndex->getPopData().endorsedBy.size(), 1);
 
   EXPECT_TRUE(alttree.setState(forkchain2.rbegin()->getHash(), state));
   EXPECT_TRUE(state.IsValid());
@@ -106,3 +108,67 @@ TEST_F(AltTreeFixture, invalidate_block_test1) {
   EXPECT_EQ(alttree.vbk().getBestChain().tip()->getHash(),
             popminer.vbk().getBestChain().tip()->getHash());
 }
+
+TEST_F(AltTreeFixture, SaveAndLoadTree) {
+  std::vector<AltBlock> chain = {altparam.getBootstrapBlock()};
+  mineAltBlocks(20, chain);
+  auto forkchain = chain;
+  forkchain.resize(10);
+  mineAltBlocks(12, forkchain);
+
+  // endorse block 5 in the main chain
+  AltBlock endorsedBlock = chain[5];
+  VbkTx tx = popminer.endorseAltBlock(generatePublicationData(endorsedBlock));
+  AltBlock containingBlock = generateNextBlock(*chain.rbegin());
+  chain.push_back(containingBlock);
+  AltPayloads payloads = generateAltPayloads(
+      tx, containingBlock, endorsedBlock, vbkparam.getGenesisBlock().getHash());
+  ASSERT_TRUE(alttree.acceptBlock(containingBlock, state));
+  ASSERT_TRUE(alttree.addPayloads(containingBlock, {payloads}, state))
+      << state.toString();
+  ASSERT_TRUE(alttree.setState(containingBlock.getHash(), state));
+
+  BlockRepositoryInmem<BlockIndex<BtcBlock>> btcRepo;
+  BlockRepositoryInmem<BlockIndex<VbkBlock>> vbkRepo;
+  BlockRepositoryInmem<BlockIndex<AltBlock>> altRepo;
+  ASSERT_TRUE(saveTrees(alttree, btcRepo, vbkRepo, altRepo, state))
+      << state.toString();
+
+  AltTree loaded(altparam, vbkparam, btcparam);
+  ASSERT_TRUE(loadTrees(loaded, btcRepo, vbkRepo, altRepo, state))
+      << state.toString();
+
+  ASSERT_EQ(loaded.getValidBlocks().size(), alttree.getValidBlocks().size());
+  ASSERT_EQ(loaded.getForkChains().size(), alttree.getForkChains().size());
+  ASSERT_EQ(loaded.getState()->getHash(), containingBlock.getHash());
+  ASSERT_EQ(loaded.vbk().getBestChain().tip()->getHash(),
+            alttree.vbk().getBestChain().tip()->getHash());
+
+  // POP data of blocks is restored
+  auto* containing = loaded.getBlockIndex(containingBlock.getHash());
+  auto* original = alttree.getBlockIndex(containingBlock.getHash());
+  ASSERT_TRUE(containing);
+  ASSERT_EQ(containing->getPopData().containingEndorsements.size(), 1);
+  const auto& context = containing->getPopData().containingContext;
+  const auto& originalContext = original->getPopData().containingContext;
+  ASSERT_EQ(context.vbk.size(), originalContext.vbk.size());
+  for (size_t i = 0; i < context.vbk.size(); i++) {
+    ASSERT_EQ(*context.vbk[i], *originalContext.vbk[i]);
+  }
+  ASSERT_EQ(context.vtbs, originalContext.vtbs);
+  auto& containingEndorsements =
+      containing->getPopData().containingEndorsements;
+  ASSERT_EQ(
+      loaded.getBlockIndex(endorsedBlock.getHash())->getPopData().endorsedBy,
+      std::vector<VbkEndorsement*>{
+          containingEndorsements.begin()->second.get()});
+
+  // restored tree makes same decisions
+  ASSERT_EQ(loaded.compareTwoBranches(chain.rbegin()->getHash(),
+                                      forkchain.rbegin()->getHash()),
+            alttree.compareTwoBranches(chain.rbegin()->getHash(),
+                                       forkchain.rbegin()->getHash()));
+  ValidationState state2;
+  ASSERT_EQ(loaded.getPopPayout(containingBlock.getHash(), state2),
+            alttree.getPopPayout(containingBlock.getHash(), state));
+}
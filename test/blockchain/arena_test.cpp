@@ -0,0 +1,65 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <veriblock/blockchain/arena.hpp>
+
+using namespace altintegration;
+
+TEST(Arena, AddressesAreStable) {
+  Arena<std::string, 4> arena;
+  std::vector<std::string*> objects;
+  for (int i = 0; i < 10; i++) {
+    auto* s = arena.create();
+    ASSERT_TRUE(s->empty());
+    *s = std::to_string(i);
+    objects.push_back(s);
+  }
+
+  ASSERT_EQ(arena.size(), 10);
+  // new slabs do not move objects from previous slabs
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(*objects[i], std::to_string(i));
+  }
+}
+
+TEST(Arena, ReleasedObjectsAreReused) {
+  Arena<std::string, 4> arena;
+  auto* a = arena.create();
+  auto* b = arena.create();
+  *a = "a";
+  *b = "b";
+
+  arena.release(a);
+  ASSERT_EQ(arena.size(), 1);
+
+  auto* c = arena.create();
+  ASSERT_EQ(c, a);
+  ASSERT_TRUE(c->empty());
+  ASSERT_EQ(*b, "b");
+  ASSERT_EQ(arena.size(), 2);
+}
+
+TEST(Arena, DeferredObjectsAreReleasedUnlessUsed) {
+  Arena<std::string, 4> arena;
+  auto* a = arena.create();
+  auto* b = arena.create();
+  *a = "a";
+  *b = "b";
+
+  arena.defer(a);
+  arena.defer(a);
+  arena.defer(b);
+  ASSERT_TRUE(arena.hasDeferred());
+  ASSERT_EQ(arena.size(), 2);
+
+  arena.releaseDeferred([](const std::string& s) { return s == "b"; });
+  ASSERT_FALSE(arena.hasDeferred());
+  ASSERT_EQ(arena.size(), 1);
+  ASSERT_EQ(*b, "b");
+  ASSERT_EQ(arena.create(), a);
+}
@@ -0,0 +1,27 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "veriblock/blockchain/block_proof_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "veriblock/blockchain/btc_blockchain_util.hpp"
+#include "veriblock/blockchain/vbk_blockchain_util.hpp"
+
+using namespace altintegration;
+
+TEST(BlockProofCache, SameAsUncached) {
+  BtcBlock btc;
+  VbkBlock vbk;
+  for (uint32_t bits : {0x1d00ffffu, 0x207fffffu, 0x1b0404cbu, 0u}) {
+    btc.bits = bits;
+    vbk.difficulty = (int32_t)bits;
+    // second call is served from the cache
+    for (int i = 0; i < 2; i++) {
+      ASSERT_EQ(getBlockProofCached(btc), getBlockProof(btc));
+      ASSERT_EQ(getBlockProofCached(vbk), getBlockProof(vbk));
+    }
+  }
+}
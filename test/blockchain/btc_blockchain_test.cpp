@@ -135,6 +135,71 @@ TEST_P(AcceptTest, BootstrapWithChain) {
   }
 }
 
+TEST_P(AcceptTest, ChainWindowMatchesChainWalk) {
+  auto value = GetParam();
+  auto allblocks = value.getBlocks();
+  allblocks = std::vector<BtcBlock>{allblocks.begin() + value.startHeight,
+                                    allblocks.end()};
+
+  BlockTree<BtcBlock, BtcChainParams> tree(*value.params);
+  ASSERT_TRUE(tree.bootstrapWithChain(value.startHeight, allblocks, state))
+      << state.GetDebugMessage();
+
+  // without window, checks fall back to walking the chain
+  const auto interval = value.params->getDifficultyAdjustmentInterval();
+  ChainWindow<BtcBlock> window;
+  ASSERT_TRUE(tree.getChainWindow(*tree.getBestChain().tip(), window));
+  for (auto* index : tree.getBestChain()) {
+    if (!tree.getChainWindow(*index, window)) {
+      // evicted
+      continue;
+    }
+
+    ASSERT_EQ(getMedianTimePast(*index, &window), getMedianTimePast(*index))
+        << index->height;
+    if ((index->height + 1) % interval == 0) {
+      // retargeting does not use the window
+      continue;
+    }
+
+    // next block is not a min difficulty block
+    BtcBlock next;
+    next.timestamp = index->getBlockTime();
+    ASSERT_EQ(getNextWorkRequired(*index, next, *value.params, &window),
+              getNextWorkRequired(*index, next, *value.params))
+        << index->height;
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(AcceptBlocksRegression,
                          AcceptTest,
                          testing::ValuesIn(accept_test_cases));
+
+struct ArenaSizeTree : public BlockTree<BtcBlock, BtcChainParams> {
+  using BlockTree::BlockTree;
+  size_t arenaSize() const { return arena_->size(); }
+};
+
+TEST(BtcBlockchain, RolledBackBlocksOfSharedArenaAreReleased) {
+  BtcChainParamsRegTest params;
+  Miner<BtcBlock, BtcChainParams> miner(params);
+  ArenaSizeTree tree(params);
+  ValidationState state;
+  ASSERT_TRUE(tree.bootstrapWithGenesis(state));
+  const auto size = tree.arenaSize();
+
+  {
+    // copy shares the arena, so rolled back block can not be released yet
+    ArenaSizeTree copy = tree;
+    UndoLogScope<ArenaSizeTree> speculative(tree);
+    ASSERT_TRUE(tree.acceptBlock(
+        miner.createNextBlock(*tree.getBestChain().tip()), state));
+  }
+  ASSERT_EQ(tree.arenaSize(), size + 1);
+
+  // copy is gone, rolled back block is reused
+  ASSERT_TRUE(tree.acceptBlock(
+      miner.createNextBlock(*tree.getBestChain().tip()), state));
+  ASSERT_EQ(tree.arenaSize(), size + 1);
+  ASSERT_EQ(tree.getBestChain().tip()->height, 1);
+}
@@ -5,7 +5,11 @@
 
 #include <gtest/gtest.h>
 
+#include <set>
+
 #include <util/pop_test_fixture.hpp>
+#include <veriblock/state_utils.hpp>
+#include <veriblock/storage/block_repository_inmem.hpp>
 
 using namespace altintegration;
 
@@ -83,7 +87,7 @@ TEST_F(BlockchainFixture, InvalidBlockAsBaseOfMultipleForks) {
   // expect chain  (a) to become new best
   // expect chains (c-f) are completely invalid
   // expect chain  (b) blocks 6-10 to be invalidated
-  // expect block 5 from (b) to be added to forkChains as new candidate fork
+  // expect block 5 from (b) to be added as new fork candidate
 
   auto& btc = popminer.btc();
   auto* fourth = btc.getBestChain().tip()->getAncestor(4);
@@ -139,9 +143,161 @@ TEST_F(BlockchainFixture, InvalidBlockAsBaseOfMultipleForks) {
   forEach(Echain, getFailedBlockIndex);
   forEach(Fchain, getFailedBlockIndex);
 
-  // there's only one chain (no known forks)
-  const auto& forkChains = btc.getForkChains();
-  ASSERT_EQ(forkChains.size(), 1);
-  // block 5 at (b) should become new fork chain
-  ASSERT_EQ(*forkChains.begin()->second.tip(), *Btip->getAncestor(5));
-}
\ No newline at end of file
+  // there's only one fork
+  const auto& forks = btc.getForkCandidates();
+  ASSERT_EQ(forks.size(), 1);
+  // block 5 at (b) should become new fork candidate
+  ASSERT_EQ(*forks.begin()->second, *Btip->getAncestor(5));
+}
+TEST_F(BlockchainFixture, InvalidateSubtreeThroughChildren) {
+  // 0-1-2-3-4-5-6-7-8-9-10   (a)
+  //           |\6-7         (b)
+  //            \6           (c)
+  // invalidate block 6 at (b), then block 5, which is base of all forks
+  auto& btc = popminer.btc();
+  auto* fifth = btc.getBestChain().tip()->getAncestor(5);
+  auto* Btip = popminer.mineBtcBlocks(*fifth, 2);
+  auto* Ctip = popminer.mineBtcBlocks(*fifth, 1);
+
+  // block 5 has 3 children, most recent first
+  ASSERT_EQ(fifth->pfirstChild, Ctip);
+  ASSERT_EQ(Ctip->pnextSibling, Btip->pprev);
+  ASSERT_EQ(Btip->pprev->pnextSibling, tip->getAncestor(6));
+  ASSERT_EQ(tip->getAncestor(6)->pnextSibling, nullptr);
+
+  btc.invalidateBlockByIndex(Btip->pprev);
+  ASSERT_EQ(btc.getFailedBlocks().size(), 2);
+  ASSERT_EQ(*btc.getBestChain().tip(), *tip);
+  ASSERT_TRUE(Btip->status & BLOCK_FAILED_CHILD);
+
+  btc.invalidateBlockByIndex(fifth);
+  // blocks 5-10 at (a), 6 at (c) and already invalid blocks of (b)
+  ASSERT_EQ(btc.getFailedBlocks().size(), 6 + 1 + 2);
+  ASSERT_EQ(*btc.getBestChain().tip(), *tip->getAncestor(4));
+  ASSERT_TRUE(Ctip->status & BLOCK_FAILED_CHILD);
+  ASSERT_TRUE(btc.getForkCandidates().empty());
+}
+
+TEST_F(BlockchainFixture, ForkCandidatesFollowForkTips) {
+  // 0-1-2-3-4-5-6-7-8-9-10   (a)
+  //          \5-6-7         (b)
+  //           \5-6          (c)
+  auto& btc = popminer.btc();
+  auto* fourth = btc.getBestChain().tip()->getAncestor(4);
+  auto* Btip = popminer.mineBtcBlocks(*fourth, 3);
+  auto* Ctip = popminer.mineBtcBlocks(*fourth, 2);
+
+  // extended forks are replaced by their new tips, most work first
+  const auto& forks = btc.getForkCandidates();
+  ASSERT_EQ(forks.size(), 2);
+  ASSERT_EQ(forks.begin()->second, Btip);
+  ASSERT_EQ(std::next(forks.begin())->second, Ctip);
+
+  // (c) overtakes (a), old tip of (a) becomes a candidate
+  auto* newCtip = popminer.mineBtcBlocks(*Ctip, 5);
+  ASSERT_EQ(btc.getBestChain().tip(), newCtip);
+  ASSERT_EQ(forks.size(), 2);
+  ASSERT_EQ(forks.begin()->second, tip);
+  ASSERT_FALSE(forks.contains(Ctip));
+  ASSERT_TRUE(forks.contains(Btip));
+
+  // only forks, which contain block 5 of (b), are its descendants
+  auto descendants = forks.getDescendantsOf(*Btip->getAncestor(5));
+  ASSERT_EQ(descendants, std::vector<BlockIndex<BtcBlock>*>{Btip});
+}
+
+TEST_F(BlockchainFixture, SaveAndLoadTree) {
+  //          /5-6-7-8-9      (a)
+  // 0-1-2-3-4-5-6-7-8-9-10   (b)
+  //             \7-8         (c)
+  // invalidate block 8 at (c), then restore the tree from the repository
+  auto& btc = popminer.btc();
+  auto* fourth = btc.getBestChain().tip()->getAncestor(4);
+  auto* sixth = btc.getBestChain().tip()->getAncestor(6);
+  popminer.mineBtcBlocks(*fourth, 5);
+  auto* Ctip = popminer.mineBtcBlocks(*sixth, 2);
+  btc.invalidateBlockByIndex(Ctip);
+
+  BlockRepositoryInmem<BlockIndex<BtcBlock>> repo;
+  saveBlockTree(btc, repo);
+
+  // every stored block survives serialization
+  auto cursor = repo.newCursor();
+  for (cursor->seekToFirst(); cursor->isValid(); cursor->next()) {
+    auto stored = cursor->value();
+    auto bytes = stored.toRaw();
+    ReadStream stream(bytes);
+    auto restored = BlockIndex<BtcBlock>::fromRaw(stream);
+    EXPECT_EQ(restored, stored);
+    EXPECT_EQ(restored.getHash(), stored.getHash());
+    EXPECT_EQ(restored.height, stored.height);
+    EXPECT_EQ(restored.status, stored.status);
+  }
+
+  BlockTree<BtcBlock, BtcChainParams> loaded(btcparam);
+  ValidationState state;
+  ASSERT_TRUE(loadBlockTree(loaded, repo, state)) << state.toString();
+
+  ASSERT_EQ(loaded.getBestChain().first()->getHash(),
+            btc.getBestChain().first()->getHash());
+  ASSERT_EQ(loaded.getBestChain().tip()->getHash(),
+            btc.getBestChain().tip()->getHash());
+  ASSERT_EQ(loaded.getBestChain().tip()->chainWork,
+            btc.getBestChain().tip()->chainWork);
+  ASSERT_EQ(loaded.getValidBlocks().size(), btc.getValidBlocks().size());
+  ASSERT_EQ(loaded.getFailedBlocks().size(), btc.getFailedBlocks().size());
+  for (const auto& failed : btc.getFailedBlocks()) {
+    auto* index = loaded.getBlockIndexFailed(failed.first);
+    ASSERT_TRUE(index);
+    ASSERT_EQ(index->status, failed.second->status);
+  }
+
+  // fork candidates may be added in different order, but they lead to same
+  // tips
+  auto forkTips = [](const BlockTree<BtcBlock, BtcChainParams>& tree) {
+    std::set<uint256> tips;
+    for (const auto& fork : tree.getForkCandidates()) {
+      tips.insert(fork.second->getHash());
+    }
+    return tips;
+  };
+  ASSERT_EQ(forkTips(loaded), forkTips(btc));
+}
+
+TEST_F(BlockchainFixture, LoadLegacyRecord) {
+  // records without version byte contain height and header only
+  auto* index = popminer.btc().getBestChain().tip();
+  WriteStream stream;
+  stream.writeBE<int32_t>(index->height);
+  index->header->toRaw(stream);
+
+  ReadStream read(stream.data());
+  auto restored = BlockIndex<BtcBlock>::fromRaw(read);
+  EXPECT_EQ(restored.getHash(), index->getHash());
+  EXPECT_EQ(restored.height, index->height);
+  EXPECT_EQ(restored.status, BLOCK_VALID_TREE);
+}
+
+TEST_F(BlockchainFixture, SaveTreeChanges) {
+  auto& btc = popminer.btc();
+  BlockRepositoryInmem<BlockIndex<BtcBlock>> repo;
+  saveBlockTree(btc, repo);
+  ASSERT_TRUE(btc.getChangedBlocks().empty());
+
+  // only new blocks and the invalidated block are written
+  auto* fifth = btc.getBestChain().tip()->getAncestor(5);
+  auto* forkTip = popminer.mineBtcBlocks(*fifth, 2);
+  btc.invalidateBlockByIndex(btc.getBestChain().tip());
+  ASSERT_EQ(btc.getChangedBlocks().size(), 3);
+  saveBlockTreeChanges(btc, repo);
+  ASSERT_TRUE(btc.getChangedBlocks().empty());
+
+  BlockTree<BtcBlock, BtcChainParams> loaded(btcparam);
+  ValidationState state;
+  ASSERT_TRUE(loadBlockTree(loaded, repo, state)) << state.toString();
+  ASSERT_EQ(loaded.getBestChain().tip()->getHash(),
+            btc.getBestChain().tip()->getHash());
+  ASSERT_EQ(loaded.getValidBlocks().size(), btc.getValidBlocks().size());
+  ASSERT_EQ(loaded.getFailedBlocks().size(), btc.getFailedBlocks().size());
+  ASSERT_TRUE(loaded.getBlockIndex(forkTip->getHash()));
+}
@@ -3,6 +3,7 @@
 
 #include <veriblock/blockchain/alt_chain_params.hpp>
 #include <veriblock/blockchain/chain.hpp>
+#include <veriblock/blockchain/chain_view.hpp>
 #include <veriblock/entities/endorsements.hpp>
 #include <veriblock/entities/payloads.hpp>
 
@@ -103,6 +104,116 @@ TEST(ChainTest, CreateFrom0) {
   ASSERT_EQ(c.chainHeight(), 109);
 }
 
+TEST(ChainTest, GetAncestorWithSkipList) {
+  const int start = 100;
+  const int size = 10000;
+  auto blocks = ChainTest::makeBlocks(start, size);
+  for (auto& block : blocks) {
+    block.buildSkip();
+  }
+
+  srand(0);
+  for (int i = 0; i < 1000; i++) {
+    auto& from = blocks[rand() % size];
+    auto height = rand() % (from.height + 1);
+    auto* expected = height < start ? nullptr : &blocks[height - start];
+    ASSERT_EQ(from.getAncestor(height), expected);
+  }
+
+  auto& tip = blocks[size - 1];
+  EXPECT_EQ(tip.getAncestor(tip.height), &tip);
+  EXPECT_EQ(tip.getAncestor(start), &blocks[0]);
+  EXPECT_EQ(tip.getAncestor(tip.height + 1), nullptr);
+  EXPECT_EQ(tip.getAncestor(-1), nullptr);
+}
+
+TEST(ChainTest, ChainViewMatchesChain) {
+  //            /fork (heights 150..199)
+  // 100 ... 149 - ... 1099 (main)
+  const int start = 100;
+  auto main = ChainTest::makeBlocks(start, 1000);
+  auto fork = ChainTest::makeBlocks(150, 50);
+  fork[0].pprev = &main[49];
+  for (auto* blocks : {&main, &fork}) {
+    for (auto& block : *blocks) {
+      block.buildSkip();
+    }
+  }
+
+  for (int viewStart : {0, start, 120, 500}) {
+    Chain<BlockIndex<DummyBlock>> chain(viewStart, &main.back());
+    ChainView<BlockIndex<DummyBlock>> view(viewStart, &main.back());
+    ASSERT_EQ(view.tip(), chain.tip());
+    ASSERT_EQ(view.chainHeight(), chain.chainHeight());
+
+    for (int h = -1; h <= chain.chainHeight() + 1; h++) {
+      ASSERT_EQ(view[h], chain[h]);
+    }
+
+    for (const auto* blocks : {&main, &fork}) {
+      for (const auto& block : *blocks) {
+        ASSERT_EQ(view.contains(&block), chain.contains(&block));
+        ASSERT_EQ(view.next(&block), chain.next(&block));
+        ASSERT_EQ(view.findFork(&block), chain.findFork(&block));
+      }
+    }
+
+    std::vector<BlockIndex<DummyBlock>*> iterated(view.begin(), view.end());
+    std::vector<BlockIndex<DummyBlock>*> expected(chain.begin(), chain.end());
+    ASSERT_EQ(iterated, expected);
+  }
+}
+
+TEST(ChainTest, FindFirstBlockWithTimeAfter) {
+  // block times grow, but may go back a bit
+  const int size = 500;
+  std::vector<BlockIndex<BtcBlock>> blocks(size);
+  srand(0);
+  uint32_t time = 1000;
+  for (int i = 0; i < size; i++) {
+    time += rand() % 20;
+    BtcBlock block;
+    block.timestamp = time - rand() % 50;
+    blocks[i].setHeader(std::make_shared<BtcBlock>(block));
+    blocks[i].height = i;
+    blocks[i].pprev = i > 0 ? &blocks[i - 1] : nullptr;
+  }
+
+  auto naive = [&](const Chain<BlockIndex<BtcBlock>>& chain,
+                   int height,
+                   uint32_t t) -> BlockIndex<BtcBlock>* {
+    for (int h = std::max(height, chain.getStartHeight());
+         h <= chain.chainHeight();
+         h++) {
+      if (chain[h]->getBlockTime() > t) {
+        return chain[h];
+      }
+    }
+    return nullptr;
+  };
+
+  Chain<BlockIndex<BtcBlock>> chain(10, &blocks[size - 1]);
+  auto check = [&]() {
+    for (int i = 0; i < 300; i++) {
+      int height = rand() % (size + 10) - 5;
+      uint32_t t = 900 + rand() % (time - 800);
+      ASSERT_EQ(chain.findFirstBlockWithTimeAfter(height, t),
+                naive(chain, height, t));
+    }
+  };
+
+  check();
+  // index is updated when chain changes
+  chain.setTip(&blocks[300]);
+  check();
+  chain.disconnectTip();
+  check();
+  chain.setTip(&blocks[200]);
+  check();
+  chain.setTip(&blocks[size - 1]);
+  check();
+}
+
 template <typename Block, typename Endorsement>
 Endorsement generateEndorsement(const Block& endorsedBlock,
                                 const Block& containingBlock) {
@@ -194,9 +305,9 @@ TYPED_TEST_P(ChainTestFixture, findEndorsement) {
   endorsement_t endorsement2 = generateEndorsement<block_t, endorsement_t>(
       *chain.tip()->pprev->header, *newIndex.header);
 
-  newIndex.containingEndorsements[endorsement1.id] =
+  newIndex.touchPopData().containingEndorsements[endorsement1.id] =
       std::make_shared<endorsement_t>(endorsement1);
-  newIndex.containingEndorsements[endorsement2.id] =
+  newIndex.touchPopData().containingEndorsements[endorsement2.id] =
       std::make_shared<endorsement_t>(endorsement2);
 
   chain.setTip(&newIndex);
@@ -208,19 +319,19 @@ TYPED_TEST_P(ChainTestFixture, findEndorsement) {
   endorsement_t endorsement4 = generateEndorsement<block_t, endorsement_t>(
       *chain.tip()->pprev->header, *newIndex2.header);
 
-  newIndex2.containingEndorsements[endorsement3.id] =
+  newIndex2.touchPopData().containingEndorsements[endorsement3.id] =
       std::make_shared<endorsement_t>(endorsement3);
 
   chain.setTip(&newIndex2);
 
   EXPECT_EQ(*chain.findBlockContainingEndorsement(endorsement1, 100)
-                 ->containingEndorsements[endorsement1.id],
+                 ->getPopData().containingEndorsements.at(endorsement1.id),
             endorsement1);
   EXPECT_EQ(*chain.findBlockContainingEndorsement(endorsement2, 100)
-                 ->containingEndorsements[endorsement2.id],
+                 ->getPopData().containingEndorsements.at(endorsement2.id),
             endorsement2);
   EXPECT_EQ(*chain.findBlockContainingEndorsement(endorsement3, 100)
-                 ->containingEndorsements[endorsement3.id],
+                 ->getPopData().containingEndorsements.at(endorsement3.id),
             endorsement3);
   EXPECT_EQ(chain.findBlockContainingEndorsement(endorsement4, 100), nullptr);
 }
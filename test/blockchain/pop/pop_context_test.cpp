@@ -124,9 +124,9 @@ TEST_F(PopContextFixture, A) {
   // and now accept VBK tip again, with VTBs
   acceptAllVtbsFromVBKblock(vbkTip);
   auto* localB = local.getBlockIndex(vbkTip->getHash());
-  if (!localB->containingContext.empty()) {
+  if (!localB->getPopData().containingContext.empty()) {
     std::vector<BtcBlock> allBtcBlocks;
-    for (const auto& el : localB->containingContext.btc_context) {
+    for (const auto& el : localB->getPopData().containingContext.btc_context) {
       for (const auto& b : el.second) {
         allBtcBlocks.push_back(*b);
       }
@@ -146,9 +146,9 @@ TEST_F(PopContextFixture, A) {
   // now we add VTB from btcA
   acceptAllVtbsFromVBKblock(vbkTip->pprev);
   auto* localA = local.getBlockIndex(vbkTip->pprev->getHash());
-  if (!localA->containingContext.empty()) {
+  if (!localA->getPopData().containingContext.empty()) {
     std::vector<BtcBlock> allBtcBlocks;
-    for (const auto& el : localA->containingContext.btc_context) {
+    for (const auto& el : localA->getPopData().containingContext.btc_context) {
       for (const auto& b : el.second) {
         allBtcBlocks.push_back(*b);
       }
@@ -120,15 +120,15 @@ TEST_F(VbkBlockTreeTestFixture, addAllPayloads_failure_test) {
 
   // Make 5 endorsements valid endorsements
   auto* endorsedVbkBlock1 = vbkBlockTip->getAncestor(vbkBlockTip->height - 11);
-  ASSERT_EQ(endorsedVbkBlock1->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock1->getPopData().endorsedBy.size(), 0);
   auto* endorsedVbkBlock2 = vbkBlockTip->getAncestor(vbkBlockTip->height - 12);
-  ASSERT_EQ(endorsedVbkBlock2->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock2->getPopData().endorsedBy.size(), 0);
   auto* endorsedVbkBlock3 = vbkBlockTip->getAncestor(vbkBlockTip->height - 13);
-  ASSERT_EQ(endorsedVbkBlock3->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock3->getPopData().endorsedBy.size(), 0);
   auto* endorsedVbkBlock4 = vbkBlockTip->getAncestor(vbkBlockTip->height - 14);
-  ASSERT_EQ(endorsedVbkBlock4->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock4->getPopData().endorsedBy.size(), 0);
   auto* endorsedVbkBlock5 = vbkBlockTip->getAncestor(vbkBlockTip->height - 15);
-  ASSERT_EQ(endorsedVbkBlock5->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock5->getPopData().endorsedBy.size(), 0);
 
   generatePopTx(*endorsedVbkBlock1->header);
   generatePopTx(*endorsedVbkBlock2->header);
@@ -143,11 +143,11 @@ TEST_F(VbkBlockTreeTestFixture, addAllPayloads_failure_test) {
             vbkBlockTip->getHash());
 
   // check that we have endorsements to the VbBlocks
-  ASSERT_EQ(endorsedVbkBlock1->endorsedBy.size(), 1);
-  ASSERT_EQ(endorsedVbkBlock2->endorsedBy.size(), 1);
-  ASSERT_EQ(endorsedVbkBlock3->endorsedBy.size(), 1);
-  ASSERT_EQ(endorsedVbkBlock4->endorsedBy.size(), 1);
-  ASSERT_EQ(endorsedVbkBlock5->endorsedBy.size(), 1);
+  ASSERT_EQ(endorsedVbkBlock1->getPopData().endorsedBy.size(), 1);
+  ASSERT_EQ(endorsedVbkBlock2->getPopData().endorsedBy.size(), 1);
+  ASSERT_EQ(endorsedVbkBlock3->getPopData().endorsedBy.size(), 1);
+  ASSERT_EQ(endorsedVbkBlock4->getPopData().endorsedBy.size(), 1);
+  ASSERT_EQ(endorsedVbkBlock5->getPopData().endorsedBy.size(), 1);
 
   // mine 40 Vbk blocks
   vbkBlockTip = popminer.mineVbkBlocks(40);
@@ -156,15 +156,15 @@ TEST_F(VbkBlockTreeTestFixture, addAllPayloads_failure_test) {
 
   // Make 5 endorsements valid endorsements
   endorsedVbkBlock1 = vbkBlockTip->getAncestor(vbkBlockTip->height - 11);
-  ASSERT_EQ(endorsedVbkBlock1->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock1->getPopData().endorsedBy.size(), 0);
   endorsedVbkBlock2 = vbkBlockTip->getAncestor(vbkBlockTip->height - 12);
-  ASSERT_EQ(endorsedVbkBlock2->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock2->getPopData().endorsedBy.size(), 0);
   endorsedVbkBlock3 = vbkBlockTip->getAncestor(vbkBlockTip->height - 13);
-  ASSERT_EQ(endorsedVbkBlock3->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock3->getPopData().endorsedBy.size(), 0);
   endorsedVbkBlock4 = vbkBlockTip->getAncestor(vbkBlockTip->height - 14);
-  ASSERT_EQ(endorsedVbkBlock4->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock4->getPopData().endorsedBy.size(), 0);
   endorsedVbkBlock5 = vbkBlockTip->getAncestor(vbkBlockTip->height - 15);
-  ASSERT_EQ(endorsedVbkBlock5->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock5->getPopData().endorsedBy.size(), 0);
 
   generatePopTx(*endorsedVbkBlock1->header);
   generatePopTx(*endorsedVbkBlock2->header);
@@ -180,9 +180,217 @@ TEST_F(VbkBlockTreeTestFixture, addAllPayloads_failure_test) {
   EXPECT_THROW(popminer.mineVbkBlocks(1), std::domain_error);
 
   // check that all endorsement have not been applied
-  ASSERT_EQ(endorsedVbkBlock1->endorsedBy.size(), 0);
-  ASSERT_EQ(endorsedVbkBlock2->endorsedBy.size(), 0);
-  ASSERT_EQ(endorsedVbkBlock3->endorsedBy.size(), 0);
-  ASSERT_EQ(endorsedVbkBlock4->endorsedBy.size(), 0);
-  ASSERT_EQ(endorsedVbkBlock5->endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock1->getPopData().endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock2->getPopData().endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock3->getPopData().endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock4->getPopData().endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock5->getPopData().endorsedBy.size(), 0);
+}
+
+TEST_F(VbkBlockTreeTestFixture, addPayloads_atomic_rollback_test) {
+  popminer.mineBtcBlocks(30);
+  auto* vbkBlockTip = popminer.mineVbkBlocks(65);
+
+  auto* endorsedVbkBlock1 = vbkBlockTip->getAncestor(vbkBlockTip->height - 11);
+  auto* endorsedVbkBlock2 = vbkBlockTip->getAncestor(vbkBlockTip->height - 12);
+  generatePopTx(*endorsedVbkBlock1->header);
+  generatePopTx(*endorsedVbkBlock2->header);
+  vbkBlockTip = popminer.mineVbkBlocks(1);
+
+  auto it = popminer.vbkPayloads.find(vbkBlockTip->getHash());
+  ASSERT_NE(it, popminer.vbkPayloads.end());
+  auto payloads = PartialVTB::fromVTB(it->second);
+  ASSERT_EQ(payloads.size(), 2);
+
+  // remove valid payloads, and try to add them back with the last one corrupted
+  popminer.vbk().removePayloads(vbkBlockTip, payloads);
+  ASSERT_EQ(endorsedVbkBlock1->getPopData().endorsedBy.size(), 0);
+  ASSERT_EQ(endorsedVbkBlock2->getPopData().endorsedBy.size(), 0);
+  auto before = popminer.vbk();
+
+  std::vector<uint8_t> new_hash = {1, 2, 3};
+  payloads[1].endorsement.blockOfProof = uint256(new_hash);
+
+  ValidationState state;
+  ASSERT_FALSE(
+      popminer.vbk().addPayloads(*vbkBlockTip->header, payloads, state));
+
+  // tree is left exactly as it was before addPayloads
+  EXPECT_TRUE(popminer.vbk() == before);
+  EXPECT_EQ(endorsedVbkBlock1->getPopData().endorsedBy.size(), 0);
+  EXPECT_EQ(endorsedVbkBlock2->getPopData().endorsedBy.size(), 0);
+  EXPECT_TRUE(vbkBlockTip->getPopData().containingContext.btc_context.empty());
+}
+
+TEST_F(VbkBlockTreeTestFixture, comparePopScore_does_not_change_state_test) {
+  popminer.mineBtcBlocks(30);
+  auto* vbkBlockTip = popminer.mineVbkBlocks(65);
+
+  // endorse block on the main chain
+  generatePopTx(*vbkBlockTip->getAncestor(vbkBlockTip->height - 10)->header);
+  vbkBlockTip = popminer.mineVbkBlocks(1);
+
+  // create a fork without endorsements
+  auto* forkPoint = vbkBlockTip->getAncestor(40);
+  auto* forkTip = popminer.mineVbkBlocks(*forkPoint, 40);
+
+  auto& cmp = popminer.vbk().getComparator();
+  auto* index = cmp.getIndex();
+  auto btcBefore = popminer.btc();
+
+  Chain<BlockIndex<VbkBlock>> chainA(forkPoint->height, vbkBlockTip);
+  Chain<BlockIndex<VbkBlock>> chainB(forkPoint->height, forkTip);
+  auto score = cmp.comparePopScore(chainA, chainB);
+  EXPECT_EQ(cmp.comparePopScore(chainB, chainA), -score);
+  EXPECT_EQ(cmp.comparePopScore(chainA, chainB), score);
+
+  // speculative state is reverted
+  EXPECT_EQ(cmp.getIndex(), index);
+  EXPECT_TRUE(popminer.btc() == btcBefore);
+}
+
+TEST_F(VbkBlockTreeTestFixture, comparePopScore_keystone_context_cache_test) {
+  popminer.mineBtcBlocks(30);
+  auto* vbkBlockTip = popminer.mineVbkBlocks(65);
+
+  // endorse block which connects keystone 60 to the previous one
+  generatePopTx(*vbkBlockTip->getAncestor(62)->header);
+  vbkBlockTip = popminer.mineVbkBlocks(1);
+
+  auto it = popminer.vbkPayloads.find(vbkBlockTip->getHash());
+  ASSERT_NE(it, popminer.vbkPayloads.end());
+  auto payloads = PartialVTB::fromVTB(it->second);
+  ASSERT_EQ(payloads.size(), 1);
+
+  // create a fork without endorsements
+  auto* forkPoint = vbkBlockTip->getAncestor(40);
+  auto* forkTip = popminer.mineVbkBlocks(*forkPoint, 40);
+
+  auto& cmp = popminer.vbk().getComparator();
+  Chain<BlockIndex<VbkBlock>> chainA(forkPoint->height, vbkBlockTip);
+  Chain<BlockIndex<VbkBlock>> chainB(forkPoint->height, forkTip);
+  auto score = cmp.comparePopScore(chainA, chainB);
+  EXPECT_GT(score, 0);
+
+  // nothing changed, contexts of keystone 60 of chain A and keystones 60 and
+  // 80 of chain B are reused
+  auto stats = cmp.getKeystoneContextCacheStats();
+  EXPECT_EQ(cmp.comparePopScore(chainA, chainB), score);
+  EXPECT_EQ(cmp.getKeystoneContextCacheStats().hits, stats.hits + 3);
+  EXPECT_EQ(cmp.getKeystoneContextCacheStats().misses, stats.misses);
+
+  // cached contexts are not used after endorsement is removed. Now chain B
+  // wins, because it has more keystones.
+  popminer.vbk().removePayloads(vbkBlockTip, payloads);
+  stats = cmp.getKeystoneContextCacheStats();
+  EXPECT_LT(cmp.comparePopScore(chainA, chainB), 0);
+  EXPECT_GT(cmp.getKeystoneContextCacheStats().misses, stats.misses);
+
+  // endorsement is added, then rolled back, because the next payload is
+  // invalid. Endorsements did not change, so contexts are still reused.
+  auto invalid = payloads[0];
+  invalid.containing = vbkBlockTip->pprev->header;
+  ValidationState state;
+  ASSERT_FALSE(popminer.vbk().addPayloads(
+      *vbkBlockTip->header, {payloads[0], invalid}, state));
+  ASSERT_EQ(state.GetPath(), "bad-payloads-stateful+bad-containing-block+1");
+  stats = cmp.getKeystoneContextCacheStats();
+  EXPECT_LT(cmp.comparePopScore(chainA, chainB), 0);
+  EXPECT_EQ(cmp.getKeystoneContextCacheStats().hits, stats.hits + 3);
+  EXPECT_EQ(cmp.getKeystoneContextCacheStats().misses, stats.misses);
+
+  // ... and added back
+  state = ValidationState();
+  ASSERT_TRUE(
+      popminer.vbk().addPayloads(*vbkBlockTip->header, payloads, state));
+  EXPECT_EQ(cmp.comparePopScore(chainA, chainB), score);
+}
+
+TEST_F(VbkBlockTreeTestFixture, resolveBlockOfProof_test) {
+  popminer.mineBtcBlocks(30);
+  auto* vbkBlockTip = popminer.mineVbkBlocks(65);
+  auto* endorsed = vbkBlockTip->getAncestor(62);
+  generatePopTx(*endorsed->header);
+  popminer.mineVbkBlocks(1);
+
+  const auto& endorsedBy = endorsed->getPopData().endorsedBy;
+  ASSERT_EQ(endorsedBy.size(), 1);
+  auto* e = endorsedBy[0];
+  auto& btc = popminer.vbk().getComparator().getProtectingBlockTree();
+  auto* blockOfProof = btc.getBlockIndex(e->blockOfProof);
+  ASSERT_NE(blockOfProof, nullptr);
+
+  // block of proof is resolved when endorsement is added
+  EXPECT_EQ(e->blockOfProofIndex, blockOfProof);
+  EXPECT_EQ(resolveBlockOfProof(*e, btc), blockOfProof);
+
+  // index, which is not on the best chain, is not trusted
+  BlockIndex<BtcBlock> stale = *blockOfProof;
+  setBlockOfProofIndex(*e, &stale);
+  EXPECT_EQ(resolveBlockOfProof(*e, btc), blockOfProof);
+  EXPECT_EQ(e->blockOfProofIndex, blockOfProof);
+}
+
+TEST_F(VbkBlockTreeTestFixture, endorsementIndex_test) {
+  popminer.mineBtcBlocks(30);
+  auto* vbkBlockTip = popminer.mineVbkBlocks(65);
+  auto* endorsed = vbkBlockTip->getAncestor(62);
+  generatePopTx(*endorsed->header);
+  auto* containing = popminer.mineVbkBlocks(1);
+  auto* tip = popminer.mineVbkBlocks(5);
+
+  auto it = popminer.vbkPayloads.find(containing->getHash());
+  ASSERT_NE(it, popminer.vbkPayloads.end());
+  auto payloads = PartialVTB::fromVTB(it->second);
+  ASSERT_EQ(payloads.size(), 1);
+  auto id = payloads[0].getEndorsementId();
+
+  const auto& index = popminer.vbk().getComparator().getEndorsementIndex();
+  EXPECT_EQ(index.find(id, *tip, endorsed->height + 1), containing);
+  EXPECT_EQ(index.find(id, *tip, containing->height + 1), nullptr);
+  EXPECT_EQ(index.find(id, *containing->pprev, 0), nullptr);
+
+  popminer.vbk().removePayloads(containing, payloads);
+  EXPECT_EQ(index.find(id, *tip, 0), nullptr);
+  EXPECT_EQ(index.size(), 0);
+
+  ValidationState state;
+  ASSERT_TRUE(popminer.vbk().addPayloads(*containing->header, payloads, state));
+  EXPECT_EQ(index.find(id, *tip, 0), containing);
+}
+
+TEST_F(VbkBlockTreeTestFixture, endorsedBy_remove_test) {
+  popminer.mineBtcBlocks(30);
+  auto* vbkBlockTip = popminer.mineVbkBlocks(65);
+  auto* endorsed = vbkBlockTip->getAncestor(62);
+  generatePopTx(*endorsed->header);
+  generatePopTx(*endorsed->header);
+  generatePopTx(*endorsed->header);
+  auto* containing = popminer.mineVbkBlocks(1);
+
+  auto it = popminer.vbkPayloads.find(containing->getHash());
+  ASSERT_NE(it, popminer.vbkPayloads.end());
+  auto payloads = PartialVTB::fromVTB(it->second);
+  ASSERT_EQ(payloads.size(), 3);
+
+  const auto& endorsedBy = endorsed->getPopData().endorsedBy;
+  ASSERT_EQ(endorsedBy.size(), 3);
+  auto checkLinks = [&]() {
+    for (size_t i = 0; i < endorsedBy.size(); i++) {
+      EXPECT_EQ(endorsedBy[i]->endorsedIndex, endorsed);
+      EXPECT_EQ(endorsedBy[i]->endorsedByPosition, i);
+    }
+  };
+  checkLinks();
+
+  // remove endorsement from the middle of the list
+  popminer.vbk().removePayloads(containing, {payloads[1]});
+  ASSERT_EQ(endorsedBy.size(), 2);
+  checkLinks();
+  for (const auto* e : endorsedBy) {
+    EXPECT_NE(e->id, payloads[1].getEndorsementId());
+  }
+
+  popminer.vbk().removePayloads(containing, {payloads[0], payloads[2]});
+  EXPECT_EQ(endorsedBy.size(), 0);
 }
@@ -3,6 +3,8 @@
 #include "util/pop_test_fixture.hpp"
 #include "util/visualize.hpp"
 #include "veriblock/blockchain/pop/fork_resolution.hpp"
+#include "veriblock/state_utils.hpp"
+#include "veriblock/storage/block_repository_inmem.hpp"
 
 using namespace altintegration;
 
@@ -111,7 +113,7 @@ TEST_F(PopVbkForkResolution, endorsement_not_in_the_BTC_main_chain) {
 
   vbkBlockTip = popminer.mineVbkBlocks(1);
 
-  ASSERT_EQ(vbkBlockTip->pprev->endorsedBy.size(), 1);
+  ASSERT_EQ(vbkBlockTip->pprev->getPopData().endorsedBy.size(), 1);
 
   Chain<BlockIndex<VbkBlock>> chain(0, vbkBlockTip);
 
@@ -211,7 +213,7 @@ TEST_F(PopVbkForkResolution, duplicate_endorsement_in_the_same_chain) {
 
   // mine the first endorsement
   popminer.mineVbkBlocks(1);
-  ASSERT_EQ(endorsedVbkBlock->endorsedBy.size(), 1);
+  ASSERT_EQ(endorsedVbkBlock->getPopData().endorsedBy.size(), 1);
 
   popminer.createVbkPopTxEndorsingVbkBlock(
       *btcBlockTip1->header,
@@ -388,3 +390,47 @@ TEST_F(PopVbkForkResolution, applyUnknownBtcContext) {
   // make sure VBK chain was changed
   ASSERT_NE(initialProtectedChain, *stateMachine.index());
 }
+
+TEST_F(PopVbkForkResolution, SaveAndLoadTip) {
+  popminer.mineBtcBlocks(10);
+  auto* chainBtip = popminer.mineVbkBlocks(65);
+  auto* forkPoint = chainBtip->getAncestor(50);
+  auto* chainAtip = popminer.mineVbkBlocks(*forkPoint, 10);
+
+  auto Atx1 = popminer.createBtcTxEndorsingVbkBlock(*chainAtip->header);
+  auto Abtccontaining1 = popminer.mineBtcBlocks(1);
+  popminer.createVbkPopTxEndorsingVbkBlock(
+      *Abtccontaining1->header,
+      Atx1,
+      *chainAtip->header,
+      popminer.getBtcParams().getGenesisBlock().getHash());
+  auto* Avbkcontaining1 = popminer.mineVbkBlocks(*chainAtip, 1);
+
+  // chain A is chosen by POP, although chain B has more work
+  auto& vbk = popminer.vbk();
+  ASSERT_EQ(vbk.getBestChain().tip(), Avbkcontaining1);
+  ASSERT_LT(Avbkcontaining1->chainWork, chainBtip->chainWork);
+
+  BlockRepositoryInmem<BlockIndex<BtcBlock>> btcRepo;
+  BlockRepositoryInmem<BlockIndex<VbkBlock>> vbkRepo;
+  ValidationState state;
+  ASSERT_TRUE(saveTrees(vbk, btcRepo, vbkRepo, state)) << state.toString();
+
+  VbkBlockTree loaded(popminer.getVbkParams(), popminer.getBtcParams());
+  ASSERT_TRUE(loadTrees(loaded, btcRepo, vbkRepo, state))
+      << state.toString();
+
+  ASSERT_EQ(loaded.getBestChain().tip()->getHash(),
+            Avbkcontaining1->getHash());
+  ASSERT_EQ(loaded.btc().getBestChain().tip()->getHash(),
+            vbk.btc().getBestChain().tip()->getHash());
+  ASSERT_EQ(loaded.getComparator().getIndex(), loaded.getBestChain().tip());
+
+  // POP data is restored together with blocks
+  auto* endorsed = loaded.getBlockIndex(chainAtip->getHash());
+  ASSERT_TRUE(endorsed);
+  ASSERT_EQ(endorsed->getPopData().endorsedBy.size(), 1);
+  ASSERT_EQ(
+      loaded.getBestChain().tip()->getPopData().containingEndorsements.size(),
+      Avbkcontaining1->getPopData().containingEndorsements.size());
+}
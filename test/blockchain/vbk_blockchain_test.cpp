@@ -8,6 +8,7 @@
 #include "veriblock/blockchain/block_index.hpp"
 #include "veriblock/blockchain/blocktree.hpp"
 #include "veriblock/blockchain/pop/vbk_block_tree.hpp"
+#include "veriblock/blockchain/vbk_blockchain_util.hpp"
 
 using namespace altintegration;
 
@@ -131,6 +132,85 @@ TEST_P(AcceptTest, BootstrapWithChain) {
   copy = std::move(tree);
 }
 
+TEST_P(AcceptTest, AcceptBlocksBatch) {
+  auto value = GetParam();
+  auto allblocks = value.getBlocks();
+  allblocks =
+      std::vector<VbkBlock>{allblocks.begin() + value.offset, allblocks.end()};
+  const auto bootstrapSize = value.params->numBlocksForBootstrap() * 2;
+  std::vector<VbkBlock> bootstrapChain{allblocks.begin(),
+                                       allblocks.begin() + bootstrapSize};
+  std::vector<VbkBlock> acceptChain{allblocks.begin() + bootstrapSize,
+                                    allblocks.end()};
+
+  VbkBlockTree tree(*value.params, btcparam);
+  ASSERT_TRUE(
+      tree.bootstrapWithChain(bootstrapChain[0].height, bootstrapChain, state))
+      << state.GetPath();
+
+  // break PoW of one of the blocks in the middle
+  auto invalid = acceptChain;
+  const size_t invalidIndex = invalid.size() / 2;
+  invalid[invalidIndex].nonce++;
+  while (checkProofOfWork(invalid[invalidIndex], *value.params)) {
+    invalid[invalidIndex].nonce++;
+  }
+  ASSERT_FALSE(tree.acceptBlocks(invalid, state));
+  ASSERT_EQ(state.GetPath(),
+            "blocktree-accept-blocks+" + std::to_string(invalidIndex) +
+                "+check-block+vbk-bad-pow");
+  // blocks before invalid one are accepted
+  ASSERT_EQ(tree.getBestChain().tip()->height,
+            acceptChain[invalidIndex - 1].height);
+  ASSERT_EQ(tree.getBlockIndex(acceptChain[invalidIndex].getHash()), nullptr);
+
+  state = ValidationState();
+  ASSERT_TRUE(tree.acceptBlocks(acceptChain, state)) << state.GetPath();
+  EXPECT_EQ(tree.getBestChain().tip()->height, acceptChain.back().height);
+  for (const auto& block : acceptChain) {
+    EXPECT_NE(tree.getBlockIndex(block.getHash()), nullptr);
+  }
+
+  // checking PoW on the calling thread gives the same result
+  VbkBlockTree sequential(*value.params, btcparam);
+  ASSERT_TRUE(sequential.bootstrapWithChain(
+      bootstrapChain[0].height, bootstrapChain, state));
+  ASSERT_FALSE(sequential.acceptBlocks(invalid, state, false));
+  ASSERT_EQ(sequential.getBestChain().tip()->height,
+            acceptChain[invalidIndex - 1].height);
+  state = ValidationState();
+  ASSERT_TRUE(sequential.acceptBlocks(acceptChain, state, false))
+      << state.GetPath();
+  EXPECT_EQ(*sequential.getBestChain().tip(), *tree.getBestChain().tip());
+}
+
+TEST_P(AcceptTest, ChainWindowMatchesChainWalk) {
+  auto value = GetParam();
+  auto allblocks = value.getBlocks();
+  allblocks =
+      std::vector<VbkBlock>{allblocks.begin() + value.offset, allblocks.end()};
+
+  VbkBlockTree tree(*value.params, btcparam);
+  ASSERT_TRUE(tree.bootstrapWithChain(allblocks[0].height, allblocks, state))
+      << state.GetPath();
+
+  // without window, checks fall back to walking the chain
+  ChainWindow<VbkBlock> window;
+  ASSERT_TRUE(tree.getChainWindow(*tree.getBestChain().tip(), window));
+  for (auto* index : tree.getBestChain()) {
+    if (!tree.getChainWindow(*index, window)) {
+      // evicted
+      continue;
+    }
+
+    ASSERT_EQ(getMedianTimePast(*index, &window), getMedianTimePast(*index))
+        << index->height;
+    ASSERT_EQ(getNextWorkRequired(*index, VbkBlock(), *value.params, &window),
+              getNextWorkRequired(*index, VbkBlock(), *value.params))
+        << index->height;
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(AcceptBlocksRegression,
                          AcceptTest,
                          testing::ValuesIn(accept_test_cases));
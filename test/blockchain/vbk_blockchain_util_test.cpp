@@ -255,6 +255,36 @@ TEST(Vbk, CheckBlockTime2) {
   ASSERT_TRUE(checkBlockTime(chain[chain.size() - 1], block, state));
 }
 
+TEST(Vbk, SortedTimesMatchChainWalk) {
+  // timestamps go back and forth, and repeat
+  std::vector<BlockIndex<VbkBlock>> chain(100);
+  std::vector<ChainWindow<VbkBlock>> windows(chain.size());
+  for (size_t i = 0; i < chain.size(); i++) {
+    auto& index = chain[i];
+    index.height = (int32_t)i;
+    index.header = std::make_shared<VbkBlock>();
+    index.header->timestamp = 1527000000 + (uint32_t)((i * 7919) % 37) * 60;
+    index.pprev = i == 0 ? nullptr : &chain[i - 1];
+    index.buildSkip();
+    buildSortedTimes(index, i == 0 ? nullptr : &windows[i - 1], windows[i]);
+  }
+
+  for (size_t i = 0; i < chain.size(); i++) {
+    std::vector<int64_t> times;
+    for (auto* index = &chain[i];
+         index != nullptr && times.size() < HISTORY_FOR_TIMESTAMP_AVERAGE;
+         index = index->pprev) {
+      times.push_back(index->getBlockTime());
+    }
+    std::sort(times.begin(), times.end());
+    size_t size = times.size();
+    auto expected = times[size % 2 == 0 ? (size / 2) - 1 : (size / 2)];
+
+    ASSERT_EQ(calculateMinimumTimestamp(chain[i], &windows[i]), expected) << i;
+    ASSERT_EQ(calculateMinimumTimestamp(chain[i]), expected) << i;
+  }
+}
+
 struct BlockchainTest : public ::testing::Test {
   using block_t = VbkBlock;
   using params_base_t = VbkChainParams;
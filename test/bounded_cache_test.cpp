@@ -0,0 +1,67 @@
+// Copyright (c) 2019-2020 Xenios SEZC
+// https://www.veriblock.org
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "veriblock/bounded_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "veriblock/hashutil.hpp"
+
+using namespace altintegration;
+
+static uint256 key(int i) {
+  std::vector<uint8_t> bytes{(uint8_t)i, (uint8_t)(i >> 8)};
+  return sha256(bytes);
+}
+
+TEST(BoundedCache, InsertContains) {
+  BoundedCache<uint256> cache(10);
+  ASSERT_FALSE(cache.contains(key(1)));
+  cache.insert(key(1));
+  cache.insert(key(1));
+  ASSERT_TRUE(cache.contains(key(1)));
+  ASSERT_FALSE(cache.contains(key(2)));
+  ASSERT_EQ(cache.size(), 1);
+
+  cache.clear();
+  ASSERT_FALSE(cache.contains(key(1)));
+  ASSERT_EQ(cache.size(), 0);
+}
+
+TEST(BoundedCache, InsertGet) {
+  BoundedCache<uint32_t, int> cache(10);
+  int value = 0;
+  ASSERT_FALSE(cache.get(1, value));
+  cache.insert(1, 100);
+  cache.insert(1, 200);
+  ASSERT_TRUE(cache.get(1, value));
+  ASSERT_EQ(value, 100);
+  ASSERT_FALSE(cache.get(2, value));
+  ASSERT_EQ(cache.size(), 1);
+
+  cache.insertOrAssign(1, 300);
+  cache.insertOrAssign(2, 400);
+  ASSERT_TRUE(cache.get(1, value));
+  ASSERT_EQ(value, 300);
+  ASSERT_TRUE(cache.get(2, value));
+  ASSERT_EQ(value, 400);
+  ASSERT_EQ(cache.size(), 2);
+}
+
+TEST(BoundedCache, EvictsOldest) {
+  BoundedCache<uint256> cache(3);
+  for (int i = 0; i < 7; i++) {
+    cache.insert(key(i));
+  }
+  // ring wraps around: 4, 5, 6 are left
+  ASSERT_EQ(cache.size(), 3);
+  for (int i = 0; i < 7; i++) {
+    ASSERT_EQ(cache.contains(key(i)), i >= 4) << i;
+  }
+
+  cache.setMaxSize(0);
+  cache.insert(key(7));
+  ASSERT_EQ(cache.size(), 0);
+}
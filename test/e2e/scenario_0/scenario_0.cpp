@@ -109,7 +109,7 @@ TEST_F(Scenario0, Scenario0) {
   ASSERT_TRUE(alt->acceptBlock(containing, state)) << state.toString();
   ASSERT_FALSE(alt->addPayloads(containing, {payloads}, state));
   ASSERT_EQ(
-      "bad-alt-payloads-stateful+apply-context+0+alt-accept-block+0+bad-prev-"
-      "block",
+      "bad-alt-payloads-stateful+apply-context+0+alt-accept-block+blocktree-"
+      "accept-blocks+0+bad-prev-block",
       state.GetPath());
 }
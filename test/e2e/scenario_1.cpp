@@ -127,7 +127,7 @@ struct Scenario1 : public ::testing::Test, public PopTestFixture {
     auto lastBlock = *altchain.rbegin();
     auto* index = alttree.getBlockIndex(lastBlock.getHash());
     EXPECT_NE(index, nullptr);
-    auto altContext = index->containingContext;
+    auto altContext = index->getPopData().containingContext;
     for (const auto& v : altContext.vtbs) {
       if (v == PartialVTB::fromVTB(vtb)) {
         return true;
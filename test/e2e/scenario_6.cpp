@@ -75,6 +75,6 @@ TEST_F(Scenario6, scenario_6) {
   EXPECT_EQ(test_alttree.vbk()
                 .getBestChain()
                 .tip()
-                ->containingContext.btc_context.size(),
+                ->getPopData().containingContext.btc_context.size(),
             0);
 }
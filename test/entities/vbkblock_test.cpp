@@ -76,3 +76,19 @@ TEST(VbkBlock, getBlockHash_test) {
       ArithUint256::fromHex(
           "0000000000000000000000000000480D8196D5B0B41861D032377F5165BB4452"));
 }
+
+TEST(VbkBlock, equality_test) {
+  VbkBlock a = defaultBlock;
+  VbkBlock b = defaultBlock;
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.getHash(), b.getHash());
+
+  b.nonce++;
+  EXPECT_NE(a, b);
+  EXPECT_NE(a.getHash(), b.getHash());
+
+  b = defaultBlock;
+  b.secondPreviousKeystone = uint72("B0935637860679DDD5"_unhex);
+  EXPECT_NE(a, b);
+  EXPECT_NE(a.getHash(), b.getHash());
+}
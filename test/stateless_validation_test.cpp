@@ -318,6 +318,17 @@ TEST_F(StatelessValidationTest, VbkTx_checkSignature_signature_invalid) {
   ASSERT_FALSE(checkVbkTx(tx, state));
 }
 
+TEST_F(StatelessValidationTest, VbkTx_cached_signature_invalid) {
+  ASSERT_TRUE(checkVbkTx(validVbkTx, state));
+  ASSERT_TRUE(checkVbkTx(validVbkTx, state));
+
+  // same transaction with other signature is not a cache hit
+  VbkTx tx = validVbkTx;
+  tx.signature =
+      "30440220398B74708DC8F8AEE68FCE0C47B8959E6FCE6354665DA3ED87583F708E62AA6B02202E6C00C00487763C55E92C7B8E1DD538B7375D8DF2B2117E75ACBB9DB7DEB3C7"_unhex;
+  ASSERT_FALSE(checkVbkTx(tx, state));
+}
+
 TEST_F(StatelessValidationTest, VbkTx_different_address_invalid) {
   VbkTx tx = validVbkTx;
   tx.publicKey =
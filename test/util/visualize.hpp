@@ -57,8 +57,8 @@ void WriteBlockTree(Stream& s,
 
     if constexpr (!std::is_same<DummyEndorsement,
                                 typename BlockTree::index_t::endorsement_t>{}) {
-      if (!index->containingEndorsements.empty()) {
-        for (const auto& kv : index->containingEndorsements) {
+      if (!index->getPopData().containingEndorsements.empty()) {
+        for (const auto& kv : index->getPopData().containingEndorsements) {
           auto& e = kv.second;
           if (!e) {
             continue;
@@ -10,6 +10,8 @@ struct TestCase {
   std::vector<uint8_t> hash;
 };
 
+using namespace altintegration;
+
 static std::vector<TestCase> cases = {
 
     {{/*empty*/}, "235FCE01D9434261188E046AE97ACA9EDC8530AE042B586C"_unhex},
@@ -47,3 +49,44 @@ TEST_P(VBlakeTest, Regression) {
 INSTANTIATE_TEST_SUITE_P(VBlakeRegression,
                          VBlakeTest,
                          testing::ValuesIn(cases));
+
+static std::vector<uint8_t> hashWith(vblake_impl impl,
+                                     const std::vector<uint8_t>& message) {
+  std::vector<uint8_t> hash(VBLAKE_HASH_SIZE, 0);
+  EXPECT_EQ(vblake_set_impl(impl), 0);
+  EXPECT_EQ(vblake(hash.data(), message.data(), message.size()), 0);
+  return hash;
+}
+
+TEST(VBlake, ImplementationsAreBitExact) {
+  const auto initial = vblake_get_impl();
+
+  std::vector<vblake_impl> impls;
+  for (auto impl : {VBLAKE_IMPL_SSE2, VBLAKE_IMPL_AVX2}) {
+    if (vblake_set_impl(impl) == 0) {
+      EXPECT_EQ(vblake_get_impl(), impl);
+      impls.push_back(impl);
+    }
+  }
+
+  for (auto impl : impls) {
+    for (const auto& tc : cases) {
+      EXPECT_EQ(hashWith(impl, tc.message), tc.hash) << "impl " << impl;
+    }
+
+    // patterns, which hit every bit of every message word
+    for (size_t size = 0; size <= 64; size++) {
+      for (uint8_t seed : {0x00, 0x5a, 0xff}) {
+        std::vector<uint8_t> message(size);
+        for (size_t i = 0; i < size; i++) {
+          message[i] = (uint8_t)(seed ^ (i * 37 + size));
+        }
+        EXPECT_EQ(hashWith(impl, message),
+                  hashWith(VBLAKE_IMPL_SCALAR, message))
+            << "impl " << impl << ", size " << size;
+      }
+    }
+  }
+
+  ASSERT_EQ(vblake_set_impl(initial), 0);
+}